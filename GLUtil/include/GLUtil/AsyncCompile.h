@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Common.h"
+#include "Program.h"
+#include "Shader.h"
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GLUtil {
+
+struct AsyncProgramState;
+
+// Handle to a program that is still being compiled or linked by the driver
+class ProgramFuture
+{
+private:
+	std::shared_ptr<AsyncProgramState> mState;
+public:
+	ProgramFuture();
+	ProgramFuture(std::shared_ptr<AsyncProgramState> state);
+
+	// Advances the build without blocking, returns true once the program is linked or failed
+	bool IsReady() const;
+	bool Succeeded() const;
+	void Wait() const;
+
+	// Waits for the build, the program is empty when it failed. nullptr for an invalid future.
+	Program* Get() const;
+	const std::string& GetInfoLog() const;
+
+	bool IsValid() const;
+};
+
+// Submits shaders and programs without waiting on the results.
+// With KHR_parallel_shader_compile the driver compiles and links on its own threads
+// and the completion status can be polled, without it every step blocks like Compile()/Link().
+class ShaderCompiler
+{
+private:
+	std::vector<std::shared_ptr<AsyncProgramState>> mPending;
+public:
+	ShaderCompiler(const ShaderCompiler&) = delete;
+	ShaderCompiler(ShaderCompiler&&) = delete;
+	ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+	ShaderCompiler& operator=(ShaderCompiler&&) = delete;
+
+	ShaderCompiler();
+	~ShaderCompiler();
+
+	// 0xFFFFFFFF lets the driver choose, 0 disables the driver threads
+	static void SetMaxThreads(uint32_t count);
+	static bool IsParallelSupported();
+
+	// Defines are inserted after the #version line of every source
+	ProgramFuture Submit(const ProgramSource* sources, uint32_t count, const char* defines = nullptr);
+	ProgramFuture Submit(std::initializer_list<ProgramSource> sources, const char* defines = nullptr);
+
+	// Advances all pending builds without blocking, returns the number still pending
+	uint32_t Poll();
+	void WaitAll();
+
+	uint32_t GetPendingCount() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
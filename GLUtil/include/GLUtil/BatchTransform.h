@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Vec.h"
+#include "Mat.h"
+#include "ThreadPool.h"
+
+namespace GLUtil {
+
+// The kernels work on plain pointers so they can write straight into a mapped Buffer.
+// With a pool, large batches are split across its threads.
+
+// Points are (x, y, z, 1) read from separate arrays, the last row of the matrix is ignored
+void TransformPoints(const Mat4f& m, const float* x, const float* y, const float* z, size_t count, float* outX, float* outY, float* outZ, ThreadPool* pool = nullptr);
+// Writes xyz of each point outStride bytes apart, e.g. into interleaved vertex data
+void TransformPoints(const Mat4f& m, const float* x, const float* y, const float* z, size_t count, void* out, size_t outStride = sizeof(Vec3f), ThreadPool* pool = nullptr);
+
+// out[i] = parent * matrices[i]
+void MultiplyMatrices(const Mat4f& parent, const Mat4f* matrices, size_t count, Mat4f* out, ThreadPool* pool = nullptr);
+
+// Inverse transpose of the upper 3x3, stored as three vec4 columns like a std140/std430 mat3
+void ComputeNormalMatrices(const Mat4f* matrices, size_t count, Mat3x4f* out, ThreadPool* pool = nullptr);
+
+} // namespace GLUtil
\ No newline at end of file
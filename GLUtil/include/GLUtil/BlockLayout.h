@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "Hash.h"
+#include "ProgramReflection.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace GLUtil {
+
+enum class BlockLayoutRule
+{
+	Std140,
+	Std430
+};
+
+struct BlockMember
+{
+	uint64_t hash;
+	DataType type;
+	int32_t offset;
+	int32_t arraySize;
+	int32_t arrayStride;
+	int32_t matrixStride;
+	// The matrix stride is the distance between rows then
+	bool rowMajor;
+};
+
+// Offsets and strides of the members of a uniform or shader storage block, either
+// computed with the std140/std430 rules or taken from a program's reflection.
+// Add() lays out column-major matrices and doesn't support struct members, Build() takes
+// row-major matrices from the reflection as well. Values are always passed column-major.
+class BlockLayout
+{
+private:
+	BlockLayoutRule mRule;
+	std::vector<BlockMember> mMembers;
+	std::unordered_map<uint64_t, uint32_t> mLookup;
+	int32_t mSize;
+	int32_t mAlignment;
+public:
+	BlockLayout(BlockLayoutRule rule = BlockLayoutRule::Std140);
+
+	// Array size 0 adds a single value
+	BlockLayout& Add(const char* name, DataType type, int32_t arraySize = 0);
+
+	// Members are found by the full name and by the name without the "Block." prefix.
+	// Returns false when the program has no such block.
+	bool Build(const ProgramReflection& reflection, ProgramInterface interface, uint64_t blockHash);
+	void Clear();
+
+	const BlockMember* Find(uint64_t hash) const;
+	const std::vector<BlockMember>& GetMembers() const;
+	BlockLayoutRule GetRule() const;
+	// Rounded up to the block alignment, the size needed for the backing buffer
+	int32_t GetSize() const;
+};
+
+// Packed client copy of a block. Writes only mark the bytes that changed and Flush()
+// uploads just the dirty ranges, instead of one glProgramUniform* call per member.
+class BlockMirror
+{
+private:
+	struct Range
+	{
+		int32_t begin;
+		int32_t end;
+	};
+
+	BlockLayout mLayout;
+	std::vector<uint8_t> mData;
+	std::vector<Range> mDirty;
+
+	void AddDirty(int32_t begin, int32_t end);
+public:
+	BlockMirror(BlockLayout layout);
+
+	// Returns false when the member doesn't exist or the value size doesn't match its type
+	bool Set(uint64_t hash, uint32_t index, const void* data, uint32_t size);
+	template<typename T>
+	bool Set(uint64_t hash, const T& value) { return Set(hash, 0, &value, sizeof(T)); }
+	template<typename T>
+	bool Set(uint64_t hash, uint32_t index, const T& value) { return Set(hash, index, &value, sizeof(T)); }
+
+	// Raw bytes at the block offset, for struct members and unsized arrays
+	void Write(int32_t offset, const void* data, int32_t size);
+	void MarkDirty();
+
+	// One SubData per dirty range, ranges close to each other are merged
+	void Flush(Buffer& buffer, intptr_t offset = 0);
+	// For persistently mapped buffers, the caller keeps the ranges in sync
+	void Flush(void* mapped);
+
+	bool IsDirty() const;
+	uint32_t GetDirtyRangeCount() const;
+	const void* GetData() const;
+	int32_t GetSize() const;
+	const BlockLayout& GetLayout() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "Common.h"
 #include "Object.h"
 
+#include <initializer_list>
+
 namespace GLUtil {
 
 enum class BufferTarget : uint32_t
@@ -110,6 +112,12 @@ uint32_t GetBoundBuffer(BufferTarget target);
 void BindBuffer(BufferTarget target, uint32_t buffer);
 void BindBufferBase(BufferTarget target, uint32_t index, uint32_t buffer);
 void BindBufferRange(BufferTarget target, uint32_t index, uint32_t buffer, intptr_t offset, intptr_t size);
+// Bind count buffers to the indices starting at first in one call, nullptr unbinds them.
+// With a StateCache current only the span of indices that changed is rebound.
+void BindBuffersBase(BufferTarget target, uint32_t first, int32_t count, const uint32_t* buffers);
+void BindBuffersBase(BufferTarget target, uint32_t first, std::initializer_list<uint32_t> buffers);
+void BindBuffersRange(BufferTarget target, uint32_t first, int32_t count, const uint32_t* buffers, const intptr_t* offsets, const intptr_t* sizes);
+void CopyBufferSubData(uint32_t readBuffer, uint32_t writeBuffer, intptr_t readOffset, intptr_t writeOffset, intptr_t size);
 
 class BufferBind
 {
@@ -129,11 +137,19 @@ public:
 
 class Buffer : public GLObject
 {
+private:
+	// Recorded on creation and by Storage()/Data(), so the getters don't query the driver.
+	// Buffers adopted from a raw ID leave them unknown.
+	int64_t mSize;
+	Flags<BufferStorageFlags> mStorageFlags;
+	BufferUsage mUsage;
+	bool mImmutable;
+	bool mKnown;
 public:
 	Buffer(const Buffer&) = delete;
 	Buffer(Buffer&&) noexcept = default;
 	Buffer& operator=(const Buffer&) = delete;
-	Buffer& operator=(Buffer&&) noexcept = default;
+	Buffer& operator=(Buffer&&) noexcept;
 
 	Buffer();
 	Buffer(uint32_t buffer);
@@ -144,6 +160,7 @@ public:
 	Buffer& Storage(intptr_t size, const void* data, Flags<BufferStorageFlags> flags);
 	Buffer& Data(intptr_t size, const void* data, BufferUsage usage);
 	Buffer& SubData(intptr_t offset, intptr_t size, const void* data);
+	Buffer& CopySubData(uint32_t readBuffer, intptr_t readOffset, intptr_t writeOffset, intptr_t size);
 
 	void* Map(BufferAccess access);
 	void* MapRange(intptr_t offset, intptr_t length, Flags<BufferAccessFlags> accessFLags);
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+
+#include <vector>
+
+namespace GLUtil {
+
+// Two level segregated fit allocator of offsets in [0, size), in arbitrary units.
+// Allocation and freeing are O(1), free neighbours are merged right away.
+class TlsfAllocator
+{
+private:
+	static constexpr uint32_t SecondLevelBits = 3;
+	static constexpr uint32_t SecondLevelCount = 1 << SecondLevelBits;
+	static constexpr uint32_t FirstLevelCount = 32 - SecondLevelBits + 1;
+
+	struct Node
+	{
+		uint32_t offset;
+		uint32_t size;
+		uint32_t prevPhysical;
+		uint32_t nextPhysical;
+		uint32_t prevFree;
+		uint32_t nextFree;
+		bool used;
+	};
+
+	std::vector<Node> mNodes;
+	std::vector<uint32_t> mUnusedNodes;
+	uint32_t mFirstLevelMask;
+	uint32_t mSecondLevelMasks[FirstLevelCount];
+	uint32_t mHeads[FirstLevelCount * SecondLevelCount];
+	uint32_t mSize;
+	uint32_t mFreeSize;
+	uint32_t mFreeCount;
+
+	uint32_t NewNode(uint32_t offset, uint32_t size);
+	void InsertFree(uint32_t node);
+	void RemoveFree(uint32_t node);
+public:
+	static constexpr uint32_t Invalid = 0xFFFFFFFF;
+
+	TlsfAllocator(uint32_t size);
+
+	// Returns a handle for Free(), or Invalid when no free region is large enough
+	uint32_t Allocate(uint32_t size, uint32_t* offset);
+	void Free(uint32_t handle);
+
+	uint32_t GetSize() const;
+	uint32_t GetFreeSize() const;
+	uint32_t GetFreeRegionCount() const;
+	uint32_t GetLargestFreeRegion() const;
+};
+
+// Indices to draw with glMultiDrawElementsBaseVertex, or firstIndex and baseVertex
+// of a DrawElementsIndirectCommand
+struct ArenaAllocation
+{
+	uint32_t block;
+	int32_t baseVertex;
+	uint32_t vertexCount;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	intptr_t indexOffset;
+	uint32_t vertexHandle;
+	uint32_t indexHandle;
+
+	bool IsValid() const;
+};
+
+// Fragmentation is 1 - largest free region / free size, 0 when the free space is contiguous
+struct BufferArenaStats
+{
+	uint32_t blockCount;
+	uint32_t allocationCount;
+	int64_t vertexBytes;
+	int64_t vertexBytesUsed;
+	int64_t indexBytes;
+	int64_t indexBytesUsed;
+	uint32_t freeRegionCount;
+	float vertexFragmentation;
+	float indexFragmentation;
+};
+
+// Packs the vertices and indices of many meshes of one vertex format into a few large
+// immutable buffers, so a scene binds one vertex and index buffer per block instead of
+// one per mesh. Blocks are added when no block has room, meshes larger than a block
+// get a block of their own.
+class BufferArena
+{
+private:
+	struct Block
+	{
+		Buffer vertices;
+		Buffer indices;
+		TlsfAllocator vertexAllocator;
+		TlsfAllocator indexAllocator;
+	};
+
+	std::vector<Block> mBlocks;
+	uint32_t mVertexStride;
+	DataType mIndexType;
+	uint32_t mIndexSize;
+	uint32_t mVerticesPerBlock;
+	uint32_t mIndicesPerBlock;
+	uint32_t mAllocationCount;
+	Flags<BufferStorageFlags> mStorageFlags;
+
+	bool AllocateInBlock(uint32_t block, uint32_t vertexCount, uint32_t indexCount, ArenaAllocation* allocation);
+public:
+	BufferArena(const BufferArena&) = delete;
+	BufferArena(BufferArena&&) = default;
+	BufferArena& operator=(const BufferArena&) = delete;
+	BufferArena& operator=(BufferArena&&) = default;
+
+	// indexType is UnsignedByte, UnsignedShort or UnsignedInt
+	BufferArena(uint32_t vertexStride, DataType indexType, uint32_t verticesPerBlock = 1 << 20, uint32_t indicesPerBlock = 1 << 22,
+		Flags<BufferStorageFlags> storageFlags = BufferStorageFlags::DynamicStorage);
+
+	ArenaAllocation Allocate(uint32_t vertexCount, uint32_t indexCount);
+	// Allocates and uploads with SubData, needs DynamicStorage
+	ArenaAllocation Allocate(uint32_t vertexCount, const void* vertices, uint32_t indexCount, const void* indices);
+	void Free(ArenaAllocation& allocation);
+
+	uint32_t GetBlockCount() const;
+	const Buffer& GetVertexBuffer(uint32_t block) const;
+	const Buffer& GetIndexBuffer(uint32_t block) const;
+	uint32_t GetVertexStride() const;
+	DataType GetIndexType() const;
+	BufferArenaStats GetStats() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "Program.h"
+#include "PipelineState.h"
+#include "Draw.h"
+
+#include <memory>
+#include <vector>
+
+namespace GLUtil {
+
+// Records GLUtil operations into an arena of memory blocks without touching GL.
+// A list is recorded by one thread at a time, so several lists can be recorded in
+// parallel on worker threads and then executed in order on the thread that owns the context.
+class CommandList
+{
+private:
+	struct Block
+	{
+		std::unique_ptr<uint8_t[]> data;
+		size_t size;
+		size_t used;
+	};
+
+	std::vector<Block> mBlocks;
+	size_t mCurrentBlock;
+	size_t mBlockSize;
+	uint32_t mCommandCount;
+
+	void* Record(uint32_t op, size_t size);
+	template<typename T>
+	CommandList& RecordUniform(const ProgramUniform& uniform, DataType type, const T& value);
+public:
+	CommandList(const CommandList&) = delete;
+	CommandList(CommandList&&) noexcept = default;
+	CommandList& operator=(const CommandList&) = delete;
+	CommandList& operator=(CommandList&&) noexcept = default;
+
+	CommandList(size_t blockSize = 64 * 1024);
+
+	// Keeps the allocated blocks for the next recording
+	void Reset();
+	void Execute() const;
+
+	CommandList& BindBuffer(BufferTarget target, uint32_t buffer);
+	CommandList& BindBufferBase(BufferTarget target, uint32_t index, uint32_t buffer);
+	CommandList& BindBufferRange(BufferTarget target, uint32_t index, uint32_t buffer, intptr_t offset, intptr_t size);
+	CommandList& BindTexture(TextureTarget target, uint32_t texture);
+	CommandList& BindTextureUnit(uint32_t unit, uint32_t texture);
+	CommandList& SetActiveTextureUnit(uint32_t unit);
+	CommandList& BindSampler(uint32_t unit, uint32_t sampler);
+	CommandList& BindVertexArray(uint32_t vertexArray);
+	CommandList& UseProgram(uint32_t program);
+
+	CommandList& SetUniform(const ProgramUniform& uniform, float v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec2f& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec3f& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec4f& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Mat2f& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Mat3f& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Mat4f& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, int32_t v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec2i& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec3i& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec4i& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, uint32_t v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec2ui& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec3ui& v);
+	CommandList& SetUniform(const ProgramUniform& uniform, const Vec4ui& v);
+
+	CommandList& EnableCapability(Capability cap);
+	CommandList& DisableCapability(Capability cap);
+	CommandList& ApplyPipelineState(const PipelineState& state);
+	CommandList& SetViewport(Box box);
+	CommandList& SetScissorBox(Box box);
+	CommandList& SetClearColor(Vec4f color);
+	CommandList& Clear(Flags<ClearMask> mask);
+
+	CommandList& DrawArrays(PrimitiveMode mode, int32_t first, int32_t count);
+	CommandList& DrawArraysInstanced(PrimitiveMode mode, int32_t first, int32_t count, int32_t instanceCount, uint32_t baseInstance = 0);
+	CommandList& DrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset);
+	CommandList& MultiDrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset, int32_t drawCount, int32_t stride = 0);
+	CommandList& DrawElements(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset);
+	CommandList& DrawElementsBaseVertex(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t baseVertex);
+	CommandList& DrawElementsInstanced(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t instanceCount, int32_t baseVertex = 0, uint32_t baseInstance = 0);
+	CommandList& DrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset);
+	CommandList& MultiDrawElementsBaseVertex(PrimitiveMode mode, const int32_t* counts, DataType type, const intptr_t* indexOffsets, int32_t drawCount, const int32_t* baseVertices);
+	CommandList& MultiDrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset, int32_t drawCount, int32_t stride = 0);
+
+	bool IsEmpty() const;
+	uint32_t GetCommandCount() const;
+	// Bytes used by the recorded commands, not counting unused block memory
+	size_t GetSize() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -1,14 +1,13 @@
 #pragma once
 
 #include "Vec.h"
+#include "GLCall.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <initializer_list>
 
-#define GLUTIL_GL_CALL(call) call
-
 namespace GLUtil {
 
 enum class DataType : uint32_t
@@ -19,4 +19,8 @@ enum class Error : uint32_t
 Error GetError();
 const char* GetErrorString(Error error);
 
+// KHR_debug groups, shown as nested regions in frame debuggers
+void PushDebugGroup(const char* message, uint32_t id = 0);
+void PopDebugGroup();
+
 } // namespace GLUtil
\ No newline at end of file
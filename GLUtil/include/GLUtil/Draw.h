@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.h"
+
+namespace GLUtil {
+
+enum class PrimitiveMode : uint32_t
+{
+	Points = 0x0000,
+	Lines = 0x0001,
+	LineLoop = 0x0002,
+	LineStrip = 0x0003,
+	Triangles = 0x0004,
+	TriangleStrip = 0x0005,
+	TriangleFan = 0x0006,
+	LinesAdjacency = 0x000A,
+	LineStripAdjacency = 0x000B,
+	TrianglesAdjacency = 0x000C,
+	TriangleStripAdjacency = 0x000D,
+	Patches = 0x000E
+};
+
+enum class ClearMask : uint32_t
+{
+	Color = 0x4000,
+	Depth = 0x0100,
+	Stencil = 0x0400
+};
+
+struct DrawArraysIndirectCommand
+{
+	uint32_t count;
+	uint32_t instanceCount;
+	uint32_t first;
+	uint32_t baseInstance;
+};
+
+struct DrawElementsIndirectCommand
+{
+	uint32_t count;
+	uint32_t instanceCount;
+	uint32_t firstIndex;
+	int32_t baseVertex;
+	uint32_t baseInstance;
+};
+
+void Clear(Flags<ClearMask> mask);
+
+// Binding a vertex array also changes the element array buffer binding
+void BindVertexArray(uint32_t vertexArray);
+
+void DrawArrays(PrimitiveMode mode, int32_t first, int32_t count);
+void DrawArraysInstanced(PrimitiveMode mode, int32_t first, int32_t count, int32_t instanceCount, uint32_t baseInstance = 0);
+void DrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset);
+void MultiDrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset, int32_t drawCount, int32_t stride = 0);
+
+// Indices are offsets into the bound element array buffer
+void DrawElements(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset);
+void DrawElementsBaseVertex(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t baseVertex);
+void DrawElementsInstanced(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t instanceCount, int32_t baseVertex = 0, uint32_t baseInstance = 0);
+void DrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset);
+void MultiDrawElementsBaseVertex(PrimitiveMode mode, const int32_t* counts, DataType type, const intptr_t* indexOffsets, int32_t drawCount, const int32_t* baseVertices);
+void MultiDrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset, int32_t drawCount, int32_t stride = 0);
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// GLUTIL_GL_CALL_MODE selects what GLUTIL_GL_CALL() does around every GL call:
+//  GLUTIL_GL_CALL_OFF    the bare call
+//  GLUTIL_GL_CALL_COUNT  counts the calls per GL entry point
+//  GLUTIL_GL_CALL_TIME   also measures the CPU time per entry point with the TSC
+//  GLUTIL_GL_CALL_CHECK  checks glGetError() after every call and reports the file and line
+//  GLUTIL_GL_CALL_TRACE  times every call on the trace clock and records it with the TraceRecorder
+#define GLUTIL_GL_CALL_OFF 0
+#define GLUTIL_GL_CALL_COUNT 1
+#define GLUTIL_GL_CALL_TIME 2
+#define GLUTIL_GL_CALL_CHECK 3
+#define GLUTIL_GL_CALL_TRACE 4
+
+#if !defined(GLUTIL_GL_CALL_MODE)
+	#define GLUTIL_GL_CALL_MODE GLUTIL_GL_CALL_OFF
+#endif
+
+#if GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TIME
+	#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		#define GLUTIL_GL_CALL_RDTSC 1
+		#include <intrin.h>
+	#elif defined(__x86_64__) || defined(__i386__)
+		#define GLUTIL_GL_CALL_RDTSC 1
+		#include <x86intrin.h>
+	#else
+		#include <chrono>
+	#endif
+#elif GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TRACE
+	#include "Trace.h"
+#endif
+
+namespace GLUtil {
+
+enum class GLCallSort
+{
+	Time,
+	Calls
+};
+
+struct GLCallStats
+{
+	const char* name;
+	uint64_t calls;
+	double milliseconds;
+};
+
+using GLErrorHandler = void(*)(uint32_t error, const char* call, const char* file, int line);
+
+// nullptr restores the default handler, which prints to stderr
+void SetGLErrorHandler(GLErrorHandler handler);
+
+// Entry points sorted by CPU time or number of calls, count 0 returns all of them.
+// Empty unless GLUtil was built with the count, time or trace mode.
+std::vector<GLCallStats> GetGLCallStats(GLCallSort sort, uint32_t count = 0);
+void DumpGLCallStats(std::FILE* file, GLCallSort sort, uint32_t count = 20);
+void ResetGLCallStats();
+
+namespace Detail {
+
+struct GLEntryPoint
+{
+	const char* name;
+	std::atomic<uint64_t> calls;
+	std::atomic<uint64_t> ticks;
+};
+
+struct GLCallSite
+{
+	GLEntryPoint* entry;
+	const char* call;
+	const char* file;
+	int line;
+};
+
+// Called once per GLUTIL_GL_CALL(), the first time it runs
+const GLCallSite* RegisterGLCallSite(const char* call, const char* file, int line);
+void CheckGLError(const GLCallSite* site);
+
+#if GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TIME
+inline uint64_t ReadTicks()
+{
+#if defined(GLUTIL_GL_CALL_RDTSC)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+#elif GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TRACE
+inline uint64_t ReadTicks()
+{
+	return TraceRecorder::Now();
+}
+#endif
+
+#define GLUTIL_GL_CALL_TIMED (GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TIME || GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TRACE)
+
+class GLCallProbe
+{
+private:
+	const GLCallSite* mSite;
+#if GLUTIL_GL_CALL_TIMED
+	uint64_t mStart;
+#endif
+public:
+	explicit GLCallProbe(const GLCallSite* site) :
+		mSite(site)
+	{
+#if GLUTIL_GL_CALL_TIMED
+		mStart = ReadTicks();
+#endif
+	}
+
+	void End()
+	{
+#if GLUTIL_GL_CALL_TIMED
+		uint64_t end = ReadTicks();
+		mSite->entry->ticks.fetch_add(end - mStart, std::memory_order_relaxed);
+#endif
+#if GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TRACE
+		TraceRecorder::RecordCpu(mSite->entry->name, mStart, end);
+#endif
+#if GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_CHECK
+		CheckGLError(mSite);
+#else
+		mSite->entry->calls.fetch_add(1, std::memory_order_relaxed);
+#endif
+	}
+};
+
+} // namespace Detail
+} // namespace GLUtil
+
+// Expands to several statements so that calls declaring a variable keep it in the
+// enclosing scope, put braces around it in unbraced ifs, loops and case labels
+#if GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_OFF
+	#define GLUTIL_GL_CALL(call) call
+#else
+	#define GLUTIL_GL_CALL_CONCAT_(a, b) a##b
+	#define GLUTIL_GL_CALL_CONCAT(a, b) GLUTIL_GL_CALL_CONCAT_(a, b)
+	#define GLUTIL_GL_CALL_IMPL(call, id) \
+		static const ::GLUtil::Detail::GLCallSite* const GLUTIL_GL_CALL_CONCAT(glCallSite, id) = ::GLUtil::Detail::RegisterGLCallSite(#call, __FILE__, __LINE__); \
+		::GLUtil::Detail::GLCallProbe GLUTIL_GL_CALL_CONCAT(glCallProbe, id)(GLUTIL_GL_CALL_CONCAT(glCallSite, id)); \
+		call; \
+		GLUTIL_GL_CALL_CONCAT(glCallProbe, id).End()
+	#define GLUTIL_GL_CALL(call) GLUTIL_GL_CALL_IMPL(call, __COUNTER__)
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Common.h"
+#include "Query.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GLUtil {
+
+// Times in milliseconds over the last historySize frames the scope was recorded in.
+// A scope entered several times in one frame counts as one sample of the summed time.
+struct GpuScopeStats
+{
+	std::string name;
+	uint32_t depth;
+	double last;
+	double min;
+	double avg;
+	double max;
+	std::vector<double> history;
+	uint32_t historyNext;
+};
+
+// Measures GPU time per scope with timestamp queries. Timestamps instead of
+// TIME_ELAPSED queries so scopes can nest. Every frame of the ring owns its queries
+// and is only read back when its slot comes around again, latency frames later,
+// so reading the results never stalls. Frames whose results still aren't available
+// by then are dropped. While a TraceRecorder capture runs the scopes are also
+// recorded on its GPU track.
+class GpuProfiler
+{
+private:
+	struct Record
+	{
+		uint32_t scope;
+		uint32_t depth;
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	struct Frame
+	{
+		std::vector<Query> queries;
+		std::vector<Record> records;
+		uint32_t queryCount;
+		bool pending;
+	};
+
+	std::vector<Frame> mFrames;
+	std::vector<GpuScopeStats> mScopes;
+	std::unordered_map<uint64_t, uint32_t> mScopeIndices;
+	std::vector<uint32_t> mStack;
+	std::vector<double> mFrameTimes;
+	uint32_t mFrameIndex;
+	uint32_t mHistorySize;
+	uint64_t mDroppedFrames;
+	bool mDebugGroups;
+	bool mInFrame;
+
+	uint32_t Timestamp(Frame& frame);
+	uint32_t GetScopeIndex(const char* name);
+	void Resolve(Frame& frame);
+	void AddSample(GpuScopeStats& stats, double time);
+public:
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler(GpuProfiler&&) = default;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(GpuProfiler&&) = default;
+
+	GpuProfiler(uint32_t latency = 4, uint32_t historySize = 64);
+
+	// The whole frame is recorded as the scope "Frame"
+	void BeginFrame();
+	void EndFrame();
+
+	// Scopes outside of a frame only push the debug group
+	void BeginScope(const char* name);
+	void EndScope();
+
+	// Pushes a KHR_debug group for every scope, on by default when supported
+	GpuProfiler& SetDebugGroups(bool enable);
+
+	const GpuScopeStats* GetStats(const char* name) const;
+	const std::vector<GpuScopeStats>& GetScopes() const;
+	uint64_t GetDroppedFrames() const;
+	void ResetStats();
+};
+
+class GpuScope
+{
+private:
+	GpuProfiler& mProfiler;
+public:
+	GpuScope(const GpuScope&) = delete;
+	GpuScope& operator=(const GpuScope&) = delete;
+
+	GpuScope(GpuProfiler& profiler, const char* name);
+	~GpuScope();
+};
+
+} // namespace GLUtil
\ No newline at end of file
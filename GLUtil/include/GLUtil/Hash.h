@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Common.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace GLUtil {
+
+constexpr uint64_t FNV1aOffset = 0xCBF29CE484222325ull;
+constexpr uint64_t FNV1aPrime = 0x00000100000001B3ull;
+
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t hash = FNV1aOffset)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ bytes[i]) * FNV1aPrime;
+	return hash;
+}
+
+// Usable in constant expressions, so names can be hashed at compile time
+constexpr uint64_t HashString(const char* str, uint64_t hash = FNV1aOffset)
+{
+	while (*str)
+		hash = (hash ^ static_cast<uint8_t>(*str++)) * FNV1aPrime;
+	return hash;
+}
+
+// Forces the hash of a string literal to be computed by the compiler
+#define GLUTIL_HASH(str) std::integral_constant<uint64_t, ::GLUtil::HashString(str)>::value
+
+// Hashes the object representation. Structs hashed or compared bytewise must have no
+// padding, their headers static_assert that the size is the sum of the member sizes.
+template<typename T>
+inline uint64_t HashValue(const T& value, uint64_t hash = FNV1aOffset)
+{
+	return HashBytes(&value, sizeof(T), hash);
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -66,4 +66,60 @@ using Mat4x3 = Mat<4, 3, T>;
 using Mat4x3f = Mat4x3<float>;
 using Mat4x3d = Mat4x3<double>;
 
+// rows[i] holds column i, matching the layout GL expects without transposing
+template<unsigned N, unsigned M, typename T>
+Vec<M, T> operator*(const Mat<N, M, T>& a, const Vec<N, T>& b)
+{
+	Vec<M, T> r = a.rows[0] * b.v[0];
+	for (unsigned i = 1; i < N; i++)
+		r += a.rows[i] * b.v[i];
+	return r;
+}
+
+template<unsigned N, unsigned M, unsigned K, typename T>
+Mat<K, M, T> operator*(const Mat<N, M, T>& a, const Mat<K, N, T>& b)
+{
+	Mat<K, M, T> r;
+	for (unsigned i = 0; i < K; i++)
+		r.rows[i] = a * b.rows[i];
+	return r;
+}
+
+template<unsigned N, typename T>
+Mat<N, N, T>& operator*=(Mat<N, N, T>& a, const Mat<N, N, T>& b)
+{
+	return a = a * b;
+}
+
+#if defined(GLUTIL_SIMD)
+
+namespace Simd {
+
+inline Float4 Transform(const Mat4f& a, Float4 b)
+{
+	Simd::Float4 r = Simd::Mul(Simd::Load(a.rows[0].v), Simd::Broadcast<0>(b));
+	r = Simd::MulAdd(Simd::Load(a.rows[1].v), Simd::Broadcast<1>(b), r);
+	r = Simd::MulAdd(Simd::Load(a.rows[2].v), Simd::Broadcast<2>(b), r);
+	return Simd::MulAdd(Simd::Load(a.rows[3].v), Simd::Broadcast<3>(b), r);
+}
+
+} // namespace Simd
+
+inline Vec4f operator*(const Mat4f& a, const Vec4f& b)
+{
+	Vec4f r;
+	Simd::Store(r.v, Simd::Transform(a, Simd::Load(b.v)));
+	return r;
+}
+
+inline Mat4f operator*(const Mat4f& a, const Mat4f& b)
+{
+	Mat4f r;
+	for (unsigned i = 0; i < 4; i++)
+		Simd::Store(r.rows[i].v, Simd::Transform(a, Simd::Load(b.rows[i].v)));
+	return r;
+}
+
+#endif
+
 } // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Common.h"
+#include "State.h"
+#include "StateCache.h"
+
+#include <functional>
+
+namespace GLUtil {
+
+struct PipelineStateDesc
+{
+	uint32_t managedCapabilities;
+	uint32_t enabledCapabilities;
+
+	CompareFunc depthFunc;
+	uint32_t depthMask;
+
+	StencilFuncState stencilFunc[2];
+	StencilOpState stencilOp[2];
+	uint32_t stencilWriteMask[2];
+
+	BlendEquationState blendEquation;
+	BlendFuncState blendFunc;
+	Vec4f blendColor;
+	Vec4b colorWriteMask;
+
+	Face cullFace;
+	FrontFaceMode frontFace;
+	PolygonMode polygonMode;
+	PolygonOffsetState polygonOffset;
+
+	uint32_t viewportSet;
+	Box viewport;
+	uint32_t scissorBoxSet;
+	Box scissorBox;
+
+	PipelineStateDesc();
+
+	// Capabilities that are neither enabled nor disabled are left untouched
+	PipelineStateDesc& EnableCapability(Capability cap);
+	PipelineStateDesc& DisableCapability(Capability cap);
+	PipelineStateDesc& SetViewport(Box box);
+	PipelineStateDesc& SetScissorBox(Box box);
+};
+
+static_assert(sizeof(PipelineStateDesc) == 7 * sizeof(uint32_t) + sizeof(CompareFunc) + 2 * sizeof(StencilFuncState) + 2 * sizeof(StencilOpState) +
+	sizeof(BlendEquationState) + sizeof(BlendFuncState) + sizeof(Vec4f) + sizeof(Vec4b) + sizeof(Face) + sizeof(FrontFaceMode) + sizeof(PolygonMode) +
+	sizeof(PolygonOffsetState) + 2 * sizeof(Box), "PipelineStateDesc is hashed bytewise and must have no padding");
+
+class PipelineState
+{
+private:
+	PipelineStateDesc mDesc;
+	uint64_t mHash;
+public:
+	PipelineState();
+	PipelineState(const PipelineStateDesc& desc);
+
+	// Issues only the calls that differ from the pipeline state applied last on this thread
+	void Apply() const;
+	// Issues every call, regardless of the state applied before
+	void ApplyAll() const;
+	// Call after state was changed through other means than pipeline states
+	static void InvalidateApplied();
+
+	const PipelineStateDesc& GetDesc() const;
+	uint64_t GetHash() const;
+
+	bool operator==(const PipelineState& other) const;
+	bool operator!=(const PipelineState& other) const;
+};
+
+} // namespace GLUtil
+
+namespace std {
+
+template<>
+struct hash<GLUtil::PipelineState>
+{
+	size_t operator()(const GLUtil::PipelineState& state) const
+	{
+		return static_cast<size_t>(state.GetHash());
+	}
+};
+
+} // namespace std
\ No newline at end of file
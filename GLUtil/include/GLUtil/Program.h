@@ -52,7 +52,8 @@ enum class ProgramProp : uint32_t
 	TransformFeedbackVaryingMaxLength = 0x8C76,
 	GeometryVerticesOut = 0x8916,
 	GeometryInputType = 0x8917,
-	GeometryOutputType = 0x8918
+	GeometryOutputType = 0x8918,
+	CompletionStatus = 0x91B1
 };
 
 enum class AtomicCounterBufferProp : uint32_t
@@ -177,8 +178,8 @@ enum class ProgramResourceProp
 
 enum class ProgramParam : uint32_t
 {
-	BinaryRetrievableHint,
-	Seperable
+	BinaryRetrievableHint = 0x8257,
+	Seperable = 0x8258
 };
 
 class ActiveAttrib
@@ -207,6 +208,12 @@ public:
 	DataType GetType() const;
 };
 
+struct ProgramSource
+{
+	ShaderType type;
+	const char* source;
+};
+
 struct AttachedShaders
 {
 	int32_t count;
@@ -335,12 +342,15 @@ public:
 	uint32_t GetIndex() const;
 };
 
+class UniformShadow;
+
 class ProgramUniform
 {
 private:
 	uint32_t mProgram;
 	int32_t mLocation;
 	uint32_t mIndex;
+	UniformShadow* mShadow;
 public:
 	ProgramUniform(const ProgramUniform&) = default;
 	ProgramUniform(ProgramUniform&&) noexcept = default;
@@ -349,7 +359,8 @@ public:
 	~ProgramUniform() = default;
 
 	ProgramUniform();
-	ProgramUniform(uint32_t program, int32_t location, uint32_t index);
+	// With a shadow the Set functions skip values the program already holds
+	ProgramUniform(uint32_t program, int32_t location, uint32_t index, UniformShadow* shadow = nullptr);
 
 	int32_t GetName(int32_t bufSize, char* name) const;
 	std::string GetName() const;
@@ -497,6 +508,7 @@ public:
 	uint32_t GetProgram() const;
 	int32_t GetLocation() const;
 	uint32_t GetIndex() const;
+	UniformShadow* GetShadow() const;
 };
 
 class ProgramAtomicCounterBuffer
@@ -592,7 +604,7 @@ public:
 	ShaderType GetShaderType() const;
 };
 
-class Program : GLObject
+class Program : public GLObject
 {
 public:
 	Program(const Program&) = delete;
@@ -614,6 +626,8 @@ public:
 	ProgramBinary GetBinary() const;
 
 	bool Link();
+	// Doesn't wait for the result, poll IsCompletionReady() before querying the status
+	void LinkAsync();
 	bool Validate();
 
 	void Use() const;
@@ -639,6 +653,7 @@ public:
 	int32_t GetResourceLocation(ProgramInterface interface, const char* name) const;
 	int32_t GetResourceLocationIndex(ProgramInterface interface, const char* name) const;
 	ProgramResource GetResource(ProgramInterface interface, const char* name) const;
+	int32_t GetNumActiveResources(ProgramInterface interface) const;
 
 	Program& BindAttribLocation(uint32_t index, const char* name);
 	Program& BindFragDataLocation(uint32_t colorNumber, const char* name);
@@ -666,6 +681,7 @@ public:
 
 	bool IsFlaggedForDelete() const;
 	bool IsLinked() const;
+	bool IsCompletionReady() const;
 	bool IsValidated() const;
 	int32_t GetInfoLogLength() const;
 	int32_t GetNumAttachedShaders() const;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Common.h"
+#include "Program.h"
+#include "Shader.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GLUtil {
+
+// Stores program binaries in a file keyed by a hash of the sources, defines and driver.
+// The file is memory mapped on open, so loading a cached program doesn't copy the binary.
+class ProgramCache
+{
+private:
+	struct Entry
+	{
+		uint32_t format;
+		int32_t length;
+		const uint8_t* mapped;
+		std::vector<uint8_t> data;
+	};
+
+	std::string mPath;
+	uint64_t mDriverHash;
+	std::unordered_map<uint64_t, Entry> mEntries;
+	const uint8_t* mMapped;
+	size_t mMappedSize;
+	bool mDirty;
+	uint32_t mHits;
+	uint32_t mMisses;
+	std::string mInfoLog;
+
+	void Open();
+	void Close();
+	void Detach();
+	bool Compile(Program& program, const ProgramSource* sources, uint32_t count, const char* defines);
+public:
+	ProgramCache(const ProgramCache&) = delete;
+	ProgramCache(ProgramCache&&) = delete;
+	ProgramCache& operator=(const ProgramCache&) = delete;
+	ProgramCache& operator=(ProgramCache&&) = delete;
+
+	// Needs a current context to identify the driver
+	ProgramCache(const char* path);
+	~ProgramCache();
+
+	// Defines are inserted after the #version line of every source.
+	// Check IsLinked() on the result, GetInfoLog() has the log of the last failed build.
+	Program Load(const ProgramSource* sources, uint32_t count, const char* defines = nullptr);
+	Program Load(std::initializer_list<ProgramSource> sources, const char* defines = nullptr);
+
+	static uint64_t Hash(const ProgramSource* sources, uint32_t count, const char* defines, uint64_t driverHash);
+	static uint64_t GetDriverHash();
+
+	bool Save();
+	void Clear();
+
+	uint32_t GetHits() const;
+	uint32_t GetMisses() const;
+	const std::string& GetInfoLog() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
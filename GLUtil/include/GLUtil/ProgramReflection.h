@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Common.h"
+#include "Hash.h"
+#include "Program.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace GLUtil {
+
+// Also used for the members of shader storage blocks, which have no location
+struct ReflectedUniform
+{
+	std::string name;
+	uint64_t hash;
+	int32_t location;
+	uint32_t index;
+	DataType type;
+	int32_t arraySize;
+	int32_t blockIndex;
+	int32_t offset;
+	int32_t arrayStride;
+	int32_t matrixStride;
+	bool rowMajor;
+};
+
+struct ReflectedBlock
+{
+	std::string name;
+	uint64_t hash;
+	uint32_t index;
+	int32_t binding;
+	int32_t dataSize;
+};
+
+struct ReflectedAttribute
+{
+	std::string name;
+	uint64_t hash;
+	int32_t location;
+	DataType type;
+	int32_t arraySize;
+};
+
+class ProgramReflection;
+
+// Client side copy of the default block uniform values of one program, indexed by location.
+// Values set through other paths (glUniform*, CommandList, other ProgramUniforms without
+// the shadow) aren't seen, call Invalidate() after those.
+class UniformShadow
+{
+private:
+	struct Slot
+	{
+		uint32_t offset;
+		uint32_t size;
+		bool valid;
+	};
+
+	std::vector<Slot> mSlots;
+	std::vector<uint8_t> mData;
+	uint64_t mUploads;
+	uint64_t mSkipped;
+public:
+	UniformShadow();
+	UniformShadow(const ProgramReflection& reflection);
+
+	void Build(const ProgramReflection& reflection);
+
+	// Returns false when the location already holds the value and the upload can be skipped.
+	// Transposed matrices are never compared, they invalidate the location.
+	bool Update(int32_t location, const void* data, uint32_t size, bool transpose = false);
+	void Invalidate();
+	void Invalidate(int32_t location);
+
+	uint64_t GetUploads() const;
+	uint64_t GetSkipped() const;
+	void ResetCounters();
+};
+
+// Snapshot of the active uniforms, uniform blocks, storage blocks and attributes of a
+// linked program. Everything is queried once in Build(), lookups go by the FNV-1a hash
+// of the name and never enter the driver:
+//	reflection.GetUniform(GLUTIL_HASH("model")).Set(model);
+// Arrays are found by both "name" and "name[0]". Rebuild after relinking.
+class ProgramReflection
+{
+private:
+	uint32_t mProgram;
+	std::vector<ReflectedUniform> mUniforms;
+	std::vector<ReflectedBlock> mUniformBlocks;
+	std::vector<ReflectedBlock> mStorageBlocks;
+	std::vector<ReflectedUniform> mBufferVariables;
+	std::vector<ReflectedAttribute> mAttributes;
+	std::unordered_map<uint64_t, uint32_t> mUniformLookup;
+	std::unordered_map<uint64_t, uint32_t> mUniformBlockLookup;
+	std::unordered_map<uint64_t, uint32_t> mStorageBlockLookup;
+	std::unordered_map<uint64_t, uint32_t> mBufferVariableLookup;
+	std::unordered_map<uint64_t, uint32_t> mAttributeLookup;
+	std::unique_ptr<UniformShadow> mShadow;
+
+	void ReflectVariables(const Program& program, ProgramInterface interface, std::vector<ReflectedUniform>& variables, std::unordered_map<uint64_t, uint32_t>& lookup);
+	void ReflectBlocks(const Program& program, ProgramInterface interface, std::vector<ReflectedBlock>& blocks, std::unordered_map<uint64_t, uint32_t>& lookup);
+public:
+	ProgramReflection(const ProgramReflection&) = delete;
+	ProgramReflection(ProgramReflection&&) noexcept = default;
+	ProgramReflection& operator=(const ProgramReflection&) = delete;
+	ProgramReflection& operator=(ProgramReflection&&) noexcept = default;
+
+	ProgramReflection();
+	ProgramReflection(const Program& program);
+	~ProgramReflection();
+
+	void Build(const Program& program);
+	void Clear();
+
+	// Uniforms returned by GetUniform() share the shadow and skip redundant uploads
+	void EnableShadow(bool enable = true);
+	UniformShadow* GetShadow() const;
+
+	// Returns nullptr when the program has no active resource with that name
+	const ReflectedUniform* FindUniform(uint64_t hash) const;
+	const ReflectedBlock* FindUniformBlock(uint64_t hash) const;
+	const ReflectedBlock* FindStorageBlock(uint64_t hash) const;
+	const ReflectedUniform* FindBufferVariable(uint64_t hash) const;
+	const ReflectedAttribute* FindAttribute(uint64_t hash) const;
+
+	// Location -1 when not found, like glGetUniformLocation
+	int32_t GetUniformLocation(uint64_t hash) const;
+	int32_t GetAttribLocation(uint64_t hash) const;
+	ProgramUniform GetUniform(uint64_t hash) const;
+	ProgramUniformBlock GetUniformBlock(uint64_t hash) const;
+
+	const std::vector<ReflectedUniform>& GetUniforms() const;
+	const std::vector<ReflectedBlock>& GetUniformBlocks() const;
+	const std::vector<ReflectedBlock>& GetStorageBlocks() const;
+	const std::vector<ReflectedUniform>& GetBufferVariables() const;
+	const std::vector<ReflectedAttribute>& GetAttributes() const;
+	uint32_t GetProgram() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common.h"
+#include "Object.h"
+
+namespace GLUtil {
+
+enum class QueryTarget : uint32_t
+{
+	SamplesPassed = 0x8914,
+	AnySamplesPassed = 0x8C2F,
+	AnySamplesPassedConservative = 0x8D6A,
+	PrimitivesGenerated = 0x8C87,
+	TransformFeedbackPrimitivesWritten = 0x8C88,
+	TimeElapsed = 0x88BF,
+	Timestamp = 0x8E28
+};
+
+class Query : public GLObject
+{
+public:
+	Query() = delete;
+	Query(const Query&) = delete;
+	Query(Query&&) noexcept = default;
+	Query& operator=(const Query&) = delete;
+	Query& operator=(Query&&) noexcept = default;
+
+	Query(uint32_t query);
+	virtual ~Query();
+
+	static Query Create(QueryTarget target);
+	static Query Gen();
+
+	void Begin(QueryTarget target) const;
+	static void End(QueryTarget target);
+	// Records the GPU time once all previous commands have completed
+	void Timestamp() const;
+
+	bool IsResultAvailable() const;
+	// Blocks until the result is available
+	uint64_t GetResult() const;
+	// Returns false without blocking when the result isn't available yet
+	bool GetResult(uint64_t* result) const;
+};
+
+// Current GPU time in nanoseconds, doesn't wait for queued commands
+uint64_t GetTimestamp();
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "BufferArena.h"
+#include "Sync.h"
+#include "Texture.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace GLUtil {
+
+struct ReadbackState;
+
+using ReadbackCallback = std::function<void(const void* data, intptr_t size)>;
+
+// Handle to data read back by an AsyncReadback, only to be used on the GL thread.
+// The data stays mapped until the last ticket of it is gone.
+class ReadbackTicket
+{
+private:
+	std::shared_ptr<ReadbackState> mState;
+public:
+	ReadbackTicket();
+	ReadbackTicket(std::shared_ptr<ReadbackState> state);
+
+	// Polls the fence without blocking
+	bool IsReady() const;
+	// Returns false when the wait failed
+	bool Wait() const;
+	// nullptr until the ticket is ready
+	const void* GetData() const;
+	intptr_t GetSize() const;
+
+	bool IsValid() const;
+};
+
+// Reads textures, the read framebuffer and buffer ranges into a persistently mapped
+// staging buffer instead of client memory, so the read doesn't drain the pipeline.
+// Every read is fenced, its ticket becomes ready a frame or two later. The staging
+// memory is sub-allocated and reclaimed in Update() once the callback ran and no
+// ticket refers to it anymore. Reads that don't fit return an invalid ticket.
+// Tickets must not outlive the AsyncReadback.
+class AsyncReadback
+{
+private:
+	static constexpr intptr_t Granularity = 16;
+
+	Buffer mStaging;
+	uint8_t* mMapped;
+	TlsfAllocator mAllocator;
+	std::vector<std::shared_ptr<ReadbackState>> mPending;
+	bool mUpdating;
+
+	std::shared_ptr<ReadbackState> Reserve(intptr_t size, ReadbackCallback callback);
+	ReadbackTicket Submit(std::shared_ptr<ReadbackState> state);
+public:
+	AsyncReadback(const AsyncReadback&) = delete;
+	AsyncReadback(AsyncReadback&&) = delete;
+	AsyncReadback& operator=(const AsyncReadback&) = delete;
+	AsyncReadback& operator=(AsyncReadback&&) = delete;
+
+	AsyncReadback(intptr_t stagingSize = 32 << 20);
+	~AsyncReadback();
+
+	// The callback runs in Update() once the data is available
+	ReadbackTicket ReadImage(const Texture& texture, int32_t level, Vec3i offset, Vec3i size, TextureBaseFormat format, DataType type, int32_t bufSize, ReadbackCallback callback = nullptr);
+	// From the bound read framebuffer
+	ReadbackTicket ReadPixels(Vec2i offset, Vec2i size, TextureBaseFormat format, DataType type, int32_t bufSize, ReadbackCallback callback = nullptr);
+	ReadbackTicket ReadBuffer(uint32_t buffer, intptr_t offset, intptr_t size, ReadbackCallback callback = nullptr);
+
+	// Runs the callbacks of the reads that completed and reclaims unreferenced memory,
+	// returns the number of reads still in flight
+	uint32_t Update();
+	// Blocks until every read is done
+	void Finish();
+
+	uint32_t GetPendingCount() const;
+	intptr_t GetStagingUsed() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "Hash.h"
+#include "Sync.h"
+#include "Texture.h"
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GLUtil {
+
+struct BufferPoolKey
+{
+	int64_t size;
+	uint32_t flags;
+	uint32_t padding;
+
+	bool operator==(const BufferPoolKey& other) const { return size == other.size && flags == other.flags; }
+};
+
+// samples is used by the multisample targets instead of levels
+struct TextureDesc
+{
+	TextureTarget target;
+	TextureInternalFormat format;
+	Vec3i size;
+	int32_t levels;
+	int32_t samples;
+
+	bool operator==(const TextureDesc& other) const;
+	bool operator!=(const TextureDesc& other) const;
+};
+
+static_assert(sizeof(TextureDesc) == sizeof(TextureTarget) + sizeof(TextureInternalFormat) + sizeof(Vec3i) + 2 * sizeof(int32_t),
+	"TextureDesc is hashed bytewise and must have no padding");
+
+} // namespace GLUtil
+
+namespace std {
+
+template<>
+struct hash<GLUtil::BufferPoolKey>
+{
+	size_t operator()(const GLUtil::BufferPoolKey& key) const
+	{
+		return static_cast<size_t>(GLUtil::HashValue(key.flags, GLUtil::HashValue(key.size)));
+	}
+};
+
+template<>
+struct hash<GLUtil::TextureDesc>
+{
+	size_t operator()(const GLUtil::TextureDesc& desc) const
+	{
+		return static_cast<size_t>(GLUtil::HashValue(desc));
+	}
+};
+
+} // namespace std
+
+namespace GLUtil {
+
+struct ResourcePoolStats
+{
+	uint32_t freeCount;
+	uint32_t inFlightCount;
+	uint32_t outstandingCount;
+	uint64_t hits;
+	uint64_t misses;
+};
+
+// Objects released to the pool are fenced together in Update() and only handed out
+// again by Acquire() once the GPU has passed that fence.
+template<typename Key, typename T>
+class RecyclePool
+{
+private:
+	struct Batch
+	{
+		Fence fence;
+		std::vector<std::pair<Key, T>> objects;
+	};
+
+	std::unordered_map<Key, std::vector<T>> mFree;
+	std::unordered_map<uint32_t, Key> mOutstanding;
+	std::vector<std::pair<Key, T>> mReleased;
+	std::deque<Batch> mInFlight;
+	uint32_t mFreeCount;
+	uint64_t mHits;
+	uint64_t mMisses;
+protected:
+	RecyclePool() :
+		mFreeCount(0), mHits(0), mMisses(0)
+	{}
+
+	~RecyclePool()
+	{
+		Clear();
+	}
+
+	bool Take(const Key& key, T* object)
+	{
+		auto it = mFree.find(key);
+		if (it == mFree.end() || it->second.empty()) {
+			mMisses++;
+			return false;
+		}
+		*object = std::move(it->second.back());
+		it->second.pop_back();
+		mFreeCount--;
+		mHits++;
+		mOutstanding[*object] = key;
+		return true;
+	}
+
+	void Track(const Key& key, const T& object)
+	{
+		if (object)
+			mOutstanding[object] = key;
+	}
+public:
+	RecyclePool(const RecyclePool&) = delete;
+	RecyclePool& operator=(const RecyclePool&) = delete;
+
+	// Objects that didn't come from this pool are deleted right away
+	void Release(T&& object)
+	{
+		auto it = mOutstanding.find(object);
+		if (it == mOutstanding.end()) {
+			T deleted = std::move(object);
+			return;
+		}
+		mReleased.emplace_back(it->second, std::move(object));
+		mOutstanding.erase(it);
+	}
+
+	// Call once per frame, fences the objects released since the last call
+	void Update()
+	{
+		if (!mReleased.empty()) {
+			Batch batch;
+			batch.fence = Fence::Create();
+			batch.objects = std::move(mReleased);
+			mReleased.clear();
+			mInFlight.push_back(std::move(batch));
+		}
+
+		while (!mInFlight.empty() && mInFlight.front().fence.IsSignaled()) {
+			for (std::pair<Key, T>& object : mInFlight.front().objects) {
+				mFree[object.first].push_back(std::move(object.second));
+				mFreeCount++;
+			}
+			mInFlight.pop_front();
+		}
+	}
+
+	// Deletes the free objects, those in flight stay in the pool
+	void Trim()
+	{
+		mFree.clear();
+		mFreeCount = 0;
+	}
+
+	void Clear()
+	{
+		Trim();
+		mReleased.clear();
+		mInFlight.clear();
+		mOutstanding.clear();
+	}
+
+	ResourcePoolStats GetStats() const
+	{
+		uint32_t inFlight = static_cast<uint32_t>(mReleased.size());
+		for (const Batch& batch : mInFlight)
+			inFlight += static_cast<uint32_t>(batch.objects.size());
+		return { mFreeCount, inFlight, static_cast<uint32_t>(mOutstanding.size()), mHits, mMisses };
+	}
+};
+
+// Buffers are pooled by power of two size class and storage flags, Acquire() returns a
+// buffer of at least the requested size
+class BufferPool : public RecyclePool<BufferPoolKey, Buffer>
+{
+public:
+	BufferPool(const BufferPool&) = delete;
+	BufferPool& operator=(const BufferPool&) = delete;
+
+	BufferPool();
+
+	Buffer Acquire(intptr_t size, Flags<BufferStorageFlags> flags);
+
+	static intptr_t GetSizeClass(intptr_t size);
+};
+
+// Textures are pooled by their exact desc. Parameters set by a previous user are kept.
+class TexturePool : public RecyclePool<TextureDesc, Texture>
+{
+public:
+	TexturePool(const TexturePool&) = delete;
+	TexturePool& operator=(const TexturePool&) = delete;
+
+	TexturePool();
+
+	Texture Acquire(const TextureDesc& desc);
+	Texture Acquire(TextureTarget target, TextureInternalFormat format, Vec3i size, int32_t levels = 1);
+};
+
+} // namespace GLUtil
\ No newline at end of file
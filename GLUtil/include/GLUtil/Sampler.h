@@ -4,6 +4,8 @@
 #include "Object.h"
 #include "Vec.h"
 
+#include <initializer_list>
+
 namespace GLUtil {
 
 enum class SamplerParam : uint32_t
@@ -12,6 +14,7 @@ enum class SamplerParam : uint32_t
 	MagFilter = 0x2800,
 	MinLod = 0x813A,
 	MaxLod = 0x813B,
+	LodBias = 0x8501,
 	WrapS = 0x2802,
 	WrapT = 0x2803,
 	WrapR = 0x8072,
@@ -45,7 +48,7 @@ enum class TextureCompareMode : uint32_t
 	None = 0
 };
 
-class Sampler : GLObject
+class Sampler : public GLObject
 {
 public:
 	Sampler() = delete;
@@ -73,6 +76,7 @@ public:
 	Sampler& SetMagFilter(TextureFilter filter);
 	Sampler& SetMinLod(float minLod);
 	Sampler& SetMaxLod(float maxLod);
+	Sampler& SetLodBias(float lodBias);
 	Sampler& SetWrapS(TextureWrap wrap);
 	Sampler& SetWrapT(TextureWrap wrap);
 	Sampler& SetWrapR(TextureWrap wrap);
@@ -95,6 +99,7 @@ public:
 	TextureFilter GetMagFilter() const;
 	float GetMinLod() const;
 	float GetMaxLod() const;
+	float GetLodBias() const;
 	TextureWrap GetWrapS() const;
 	TextureWrap GetWrapT() const;
 	TextureWrap GetWrapR() const;
@@ -106,4 +111,10 @@ public:
 	CompareFunc GetCompareFunc() const;
 };
 
+void BindSampler(uint32_t unit, uint32_t sampler);
+// Binds count samplers to the units starting at first in one call, nullptr unbinds them.
+// With a StateCache current only the span of units that changed is rebound.
+void BindSamplers(uint32_t first, int32_t count, const uint32_t* samplers);
+void BindSamplers(uint32_t first, std::initializer_list<uint32_t> samplers);
+
 } // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Common.h"
+#include "Sampler.h"
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace GLUtil {
+
+struct SamplerDesc
+{
+	TextureFilter minFilter;
+	TextureFilter magFilter;
+	TextureWrap wrapS;
+	TextureWrap wrapT;
+	TextureWrap wrapR;
+	float minLod;
+	float maxLod;
+	float lodBias;
+	TextureCompareMode compareMode;
+	CompareFunc compareFunc;
+	Vec4f borderColor;
+
+	// GL defaults
+	SamplerDesc();
+
+	SamplerDesc& SetFilter(TextureFilter min, TextureFilter mag);
+	SamplerDesc& SetWrap(TextureWrap wrap);
+	SamplerDesc& SetCompare(CompareFunc func);
+
+	uint64_t Hash() const;
+	bool operator==(const SamplerDesc& other) const;
+	bool operator!=(const SamplerDesc& other) const;
+};
+
+static_assert(sizeof(SamplerDesc) == 2 * sizeof(TextureFilter) + 3 * sizeof(TextureWrap) + 3 * sizeof(float) + sizeof(TextureCompareMode) + sizeof(CompareFunc) + sizeof(Vec4f),
+	"SamplerDesc is hashed bytewise and must have no padding");
+
+} // namespace GLUtil
+
+namespace std {
+
+template<>
+struct hash<GLUtil::SamplerDesc>
+{
+	size_t operator()(const GLUtil::SamplerDesc& desc) const
+	{
+		return static_cast<size_t>(desc.Hash());
+	}
+};
+
+} // namespace std
+
+namespace GLUtil {
+
+// Hands out one shared sampler per distinct desc instead of a GL object per material.
+// The cache keeps its own reference, Purge() deletes the samplers nobody else holds.
+class SamplerCache
+{
+private:
+	std::unordered_map<SamplerDesc, std::shared_ptr<Sampler>> mSamplers;
+	uint64_t mHits;
+	uint64_t mMisses;
+public:
+	SamplerCache(const SamplerCache&) = delete;
+	SamplerCache(SamplerCache&&) = delete;
+	SamplerCache& operator=(const SamplerCache&) = delete;
+	SamplerCache& operator=(SamplerCache&&) = delete;
+
+	SamplerCache();
+	~SamplerCache();
+
+	std::shared_ptr<Sampler> Get(const SamplerDesc& desc);
+
+	// Returns the number of samplers deleted
+	uint32_t Purge();
+	void Clear();
+
+	uint32_t GetCount() const;
+	uint64_t GetHits() const;
+	uint64_t GetMisses() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -23,7 +23,8 @@ enum class ShaderProp : uint32_t
 	DeleteStatus = 0x8B80,
 	CompileStatus = 0x8B81,
 	InfoLogLength = 0x8B84,
-	SourceLength = 0x8B88
+	SourceLength = 0x8B88,
+	CompletionStatus = 0x91B1
 };
 
 enum class ShaderSourceType
@@ -50,10 +51,14 @@ public:
 
 	Shader& Source(int32_t count, const char* const* strings, const int32_t* lengths);
 	Shader& Source(const char* src);
+	// Inserts defines after the #version line
+	Shader& Source(const char* src, const char* defines);
 	bool SourceFile(const char* filename);
 	bool Source(ShaderSourceType srcType, const char* src);
 
 	bool Compile();
+	// Doesn't wait for the result, poll IsCompletionReady() before querying the status
+	void CompileAsync();
 
 	int32_t GetInfoLog(int32_t maxLength, char* infoLog) const;
 	std::string GetInfoLog() const;
@@ -67,6 +72,7 @@ public:
 	ShaderType GetType() const;
 	bool IsTaggedForDelete() const;
 	bool IsCompiled() const;
+	bool IsCompletionReady() const;
 	int32_t GetInfoLogLength() const;
 	int32_t GetSourceLength() const;
 };
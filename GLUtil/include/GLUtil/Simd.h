@@ -0,0 +1,151 @@
+#pragma once
+
+// Define GLUTIL_NO_SIMD to force the scalar math path
+#if !defined(GLUTIL_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define GLUTIL_SIMD_SSE 1
+		#include <emmintrin.h>
+		#if defined(__AVX__)
+			#define GLUTIL_SIMD_AVX 1
+			#include <immintrin.h>
+		#endif
+	#elif defined(__ARM_NEON) && defined(__aarch64__)
+		#define GLUTIL_SIMD_NEON 1
+		#include <arm_neon.h>
+	#endif
+#endif
+
+#if defined(GLUTIL_SIMD_SSE) || defined(GLUTIL_SIMD_NEON)
+	#define GLUTIL_SIMD 1
+#endif
+
+#if defined(GLUTIL_SIMD)
+
+namespace GLUtil {
+namespace Simd {
+
+#if defined(GLUTIL_SIMD_SSE)
+
+using Float4 = __m128;
+
+inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, Float4 a) { _mm_storeu_ps(p, a); }
+inline Float4 Splat(float a) { return _mm_set1_ps(a); }
+inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+#if defined(__FMA__)
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return _mm_fmadd_ps(a, b, c); }
+#else
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+
+template<int I>
+inline Float4 Broadcast(Float4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(I, I, I, I)); }
+
+inline float HorizontalSum(Float4 a)
+{
+	Float4 shuf = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+	Float4 sums = _mm_add_ps(a, shuf);
+	shuf = _mm_movehl_ps(shuf, sums);
+	return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+// xyz cross product, w is zero
+inline Float4 Cross(Float4 a, Float4 b)
+{
+	Float4 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	Float4 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	Float4 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+	return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+#if defined(GLUTIL_SIMD_AVX)
+
+using Double4 = __m256d;
+
+inline Double4 Load(const double* p) { return _mm256_loadu_pd(p); }
+inline void Store(double* p, Double4 a) { _mm256_storeu_pd(p, a); }
+inline Double4 Splat(double a) { return _mm256_set1_pd(a); }
+inline Double4 Add(Double4 a, Double4 b) { return _mm256_add_pd(a, b); }
+inline Double4 Sub(Double4 a, Double4 b) { return _mm256_sub_pd(a, b); }
+inline Double4 Mul(Double4 a, Double4 b) { return _mm256_mul_pd(a, b); }
+inline Double4 Div(Double4 a, Double4 b) { return _mm256_div_pd(a, b); }
+
+inline double HorizontalSum(Double4 a)
+{
+	__m128d sums = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(sums, _mm_unpackhi_pd(sums, sums)));
+}
+
+#else
+
+struct Double4
+{
+	__m128d lo, hi;
+};
+
+inline Double4 Load(const double* p) { return { _mm_loadu_pd(p), _mm_loadu_pd(p + 2) }; }
+inline void Store(double* p, Double4 a) { _mm_storeu_pd(p, a.lo); _mm_storeu_pd(p + 2, a.hi); }
+inline Double4 Splat(double a) { return { _mm_set1_pd(a), _mm_set1_pd(a) }; }
+inline Double4 Add(Double4 a, Double4 b) { return { _mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi) }; }
+inline Double4 Sub(Double4 a, Double4 b) { return { _mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi) }; }
+inline Double4 Mul(Double4 a, Double4 b) { return { _mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi) }; }
+inline Double4 Div(Double4 a, Double4 b) { return { _mm_div_pd(a.lo, b.lo), _mm_div_pd(a.hi, b.hi) }; }
+
+inline double HorizontalSum(Double4 a)
+{
+	__m128d sums = _mm_add_pd(a.lo, a.hi);
+	return _mm_cvtsd_f64(_mm_add_sd(sums, _mm_unpackhi_pd(sums, sums)));
+}
+
+#endif
+
+#elif defined(GLUTIL_SIMD_NEON)
+
+using Float4 = float32x4_t;
+
+inline Float4 Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, Float4 a) { vst1q_f32(p, a); }
+inline Float4 Splat(float a) { return vdupq_n_f32(a); }
+inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return vfmaq_f32(c, a, b); }
+
+template<int I>
+inline Float4 Broadcast(Float4 a) { return vdupq_laneq_f32(a, I); }
+
+inline float HorizontalSum(Float4 a) { return vaddvq_f32(a); }
+
+inline Float4 ShuffleYZX(Float4 a) { return vsetq_lane_f32(vgetq_lane_f32(a, 0), vextq_f32(a, a, 1), 2); }
+
+inline Float4 Cross(Float4 a, Float4 b)
+{
+	Float4 c = vsubq_f32(vmulq_f32(a, ShuffleYZX(b)), vmulq_f32(ShuffleYZX(a), b));
+	return vsetq_lane_f32(0.0f, ShuffleYZX(c), 3);
+}
+
+struct Double4
+{
+	float64x2_t lo, hi;
+};
+
+inline Double4 Load(const double* p) { return { vld1q_f64(p), vld1q_f64(p + 2) }; }
+inline void Store(double* p, Double4 a) { vst1q_f64(p, a.lo); vst1q_f64(p + 2, a.hi); }
+inline Double4 Splat(double a) { return { vdupq_n_f64(a), vdupq_n_f64(a) }; }
+inline Double4 Add(Double4 a, Double4 b) { return { vaddq_f64(a.lo, b.lo), vaddq_f64(a.hi, b.hi) }; }
+inline Double4 Sub(Double4 a, Double4 b) { return { vsubq_f64(a.lo, b.lo), vsubq_f64(a.hi, b.hi) }; }
+inline Double4 Mul(Double4 a, Double4 b) { return { vmulq_f64(a.lo, b.lo), vmulq_f64(a.hi, b.hi) }; }
+inline Double4 Div(Double4 a, Double4 b) { return { vdivq_f64(a.lo, b.lo), vdivq_f64(a.hi, b.hi) }; }
+
+inline double HorizontalSum(Double4 a) { return vaddvq_f64(vaddq_f64(a.lo, a.hi)); }
+
+#endif
+
+} // namespace Simd
+} // namespace GLUtil
+
+#endif
\ No newline at end of file
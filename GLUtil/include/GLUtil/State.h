@@ -5,35 +5,35 @@
 
 namespace GLUtil {
 
-enum class Capability
+enum class Capability : uint32_t
 {
-	Blend,
-	ClipDistance,
-	ColorLogicOp,
-	CullFace,
-	DebugOutput,
-	DebugOutputSynchronous,
-	DepthClamp,
-	DepthTest,
-	FramebufferSRGB,
-	LineSmooth,
-	Multisample,
-	PolygonOffsetFill,
-	PolygonOffsetLine,
-	PolygonOffsetPoint,
-	PolygonSmooth,
-	PrimitiveRestart,
-	PrimitiveRestartFixedIndex,
-	RasterizerDiscard,
-	SampleAlphaToCoverage,
-	SampleAlphaToOne,
-	SampleCoverage,
-	SampleShading,
-	SampleMask,
-	ScissorTest,
-	StencilTest,
-	TextureCubemapSeamless,
-	ProgramPointSize
+	Blend = 0x0BE2,
+	ClipDistance = 0x3000,
+	ColorLogicOp = 0x0BF2,
+	CullFace = 0x0B44,
+	DebugOutput = 0x92E0,
+	DebugOutputSynchronous = 0x8242,
+	DepthClamp = 0x864F,
+	DepthTest = 0x0B71,
+	FramebufferSRGB = 0x8DB9,
+	LineSmooth = 0x0B20,
+	Multisample = 0x809D,
+	PolygonOffsetFill = 0x8037,
+	PolygonOffsetLine = 0x2A02,
+	PolygonOffsetPoint = 0x2A01,
+	PolygonSmooth = 0x0B41,
+	PrimitiveRestart = 0x8F9D,
+	PrimitiveRestartFixedIndex = 0x8D69,
+	RasterizerDiscard = 0x8C89,
+	SampleAlphaToCoverage = 0x809E,
+	SampleAlphaToOne = 0x809F,
+	SampleCoverage = 0x80A0,
+	SampleShading = 0x8C36,
+	SampleMask = 0x8E51,
+	ScissorTest = 0x0C11,
+	StencilTest = 0x0B90,
+	TextureCubemapSeamless = 0x884F,
+	ProgramPointSize = 0x8642
 };
 
 enum class StateProp : uint32_t
@@ -264,138 +264,138 @@ enum class StateProp : uint32_t
 
 enum class BlendEquation : uint32_t
 {
-	Add,
-	Subtract,
-	ReverseSubtract,
-	Min,
-	Max
+	Add = 0x8006,
+	Subtract = 0x800A,
+	ReverseSubtract = 0x800B,
+	Min = 0x8007,
+	Max = 0x8008
 };
 
 enum class BlendFunc : uint32_t
 {
-	Zero,
-	One,
-	SrcColor,
-	OneMinusSrcColor,
-	DstColor,
-	OneMinusDstColor,
-	SrcAlpha,
-	OneMinusSrcAlpha,
-	DstAlpha,
-	OneMinusDstAlpha,
-	ConstantColor,
-	OneMinusConstantColor,
-	ConstantAlpha,
-	OneMinusConstantAlpha,
-	Src1Color,
-	OneMinusSrc1Color,
-	Src1Alpha,
-	OneMinusSrc1Alpha
+	Zero = 0,
+	One = 1,
+	SrcColor = 0x0300,
+	OneMinusSrcColor = 0x0301,
+	DstColor = 0x0306,
+	OneMinusDstColor = 0x0307,
+	SrcAlpha = 0x0302,
+	OneMinusSrcAlpha = 0x0303,
+	DstAlpha = 0x0304,
+	OneMinusDstAlpha = 0x0305,
+	ConstantColor = 0x8001,
+	OneMinusConstantColor = 0x8002,
+	ConstantAlpha = 0x8003,
+	OneMinusConstantAlpha = 0x8004,
+	Src1Color = 0x88F9,
+	OneMinusSrc1Color = 0x88FA,
+	Src1Alpha = 0x8589,
+	OneMinusSrc1Alpha = 0x88FB
 };
 
 enum class Origin : uint32_t
 {
-	LowerLeft,
-	UpperLeft
+	LowerLeft = 0x8CA1,
+	UpperLeft = 0x8CA2
 };
 
 enum class ClipControlDepthMode : uint32_t
 {
-	NegativeOneToOne,
-	ZeroToOne
+	NegativeOneToOne = 0x935E,
+	ZeroToOne = 0x935F
 };
 
 enum class Face : uint32_t
 {
-	Front,
-	Back,
-	FrontAndBack
+	Front = 0x0404,
+	Back = 0x0405,
+	FrontAndBack = 0x0408
 };
 
 enum class FrontFaceMode : uint32_t
 {
-	Clockwise,
-	CounterClockwise
+	Clockwise = 0x0900,
+	CounterClockwise = 0x0901
 };
 
 enum class Hint : uint32_t
 {
-	FragmentShaderDerivative,
-	LineSmooth,
-	PolygonSmooth,
-	TextureCompression
+	FragmentShaderDerivative = 0x8B8B,
+	LineSmooth = 0x0C52,
+	PolygonSmooth = 0x0C53,
+	TextureCompression = 0x84EF
 };
 
 enum class HintPreference : uint32_t
 {
-	Fastest,
-	Nicest,
-	DontCare
+	Fastest = 0x1101,
+	Nicest = 0x1102,
+	DontCare = 0x1100
 };
 
 enum class LogicOp : uint32_t
 {
-	Clear,
-	Set,
-	Copy,
-	CopyInverted,
-	NoOp,
-	Invert,
-	And,
-	Nand,
-	Or,
-	Nor,
-	Xor,
-	Equiv,
-	AndReverse,
-	AndInverted,
-	OrReverse,
-	OrInverted
+	Clear = 0x1500,
+	Set = 0x150F,
+	Copy = 0x1503,
+	CopyInverted = 0x150C,
+	NoOp = 0x1505,
+	Invert = 0x150A,
+	And = 0x1501,
+	Nand = 0x150E,
+	Or = 0x1507,
+	Nor = 0x1508,
+	Xor = 0x1506,
+	Equiv = 0x1509,
+	AndReverse = 0x1502,
+	AndInverted = 0x1504,
+	OrReverse = 0x150B,
+	OrInverted = 0x150D
 };
 
 enum class PixelStoreParam : uint32_t
 {
-	PackSwapBytes,
-	PackLsbFirst,
-	PackRowLength,
-	PackImageHeight,
-	PackSkipPixels,
-	PackSkipRows,
-	PackSkipImages,
-	PackAlignment,
-	UnpackSwapBytes,
-	UnpackLsbFirst,
-	UnpackRowLength,
-	UnpackImageHeight,
-	UnpackSkipPixels,
-	UnpackSkipRows,
-	UnpackSkipImages,
-	UnpackAlignment
+	PackSwapBytes = 0x0D00,
+	PackLsbFirst = 0x0D01,
+	PackRowLength = 0x0D02,
+	PackImageHeight = 0x806C,
+	PackSkipPixels = 0x0D04,
+	PackSkipRows = 0x0D03,
+	PackSkipImages = 0x806B,
+	PackAlignment = 0x0D05,
+	UnpackSwapBytes = 0x0CF0,
+	UnpackLsbFirst = 0x0CF1,
+	UnpackRowLength = 0x0CF2,
+	UnpackImageHeight = 0x806E,
+	UnpackSkipPixels = 0x0CF4,
+	UnpackSkipRows = 0x0CF3,
+	UnpackSkipImages = 0x806D,
+	UnpackAlignment = 0x0CF5
 };
 
 enum class PolygonMode : uint32_t
 {
-	Point,
-	Line,
-	Fill
+	Point = 0x1B00,
+	Line = 0x1B01,
+	Fill = 0x1B02
 };
 
 enum class PointParam : uint32_t
 {
-	FadeThresholdSize,
-	SpriteCoordOrigin
+	FadeThresholdSize = 0x8128,
+	SpriteCoordOrigin = 0x8CA0
 };
 
 enum class StencilOp : uint32_t
 {
-	Keep,
-	Zero,
-	Replace,
-	Increment,
-	IncrementWrap,
-	Decrement,
-	DecrementWrap,
-	Invert
+	Keep = 0x1E00,
+	Zero = 0,
+	Replace = 0x1E01,
+	Increment = 0x1E02,
+	IncrementWrap = 0x8507,
+	Decrement = 0x1E03,
+	DecrementWrap = 0x8508,
+	Invert = 0x150A
 };
 
 void SetHint(Hint hint, HintPreference preference);
@@ -561,6 +561,7 @@ void SetPolygonOffset(float factor, float units);
 
 void SetPixelStoreParamF(PixelStoreParam pname, float value);
 void SetPixelStoreParamI(PixelStoreParam pname, int32_t value);
+int32_t GetPixelStoreParamI(PixelStoreParam pname);
 
 void EnableCapability(Capability cap);
 void EnableCapability(Capability cap, uint32_t index);
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Common.h"
+#include "State.h"
+#include "Buffer.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace GLUtil {
+
+template<typename T>
+class CachedValue
+{
+private:
+	T mValue;
+	bool mValid;
+public:
+	CachedValue() :
+		mValue(), mValid(false)
+	{}
+
+	// Returns false when the value is already known to be set
+	bool Update(const T& value)
+	{
+		if (mValid && memcmp(&mValue, &value, sizeof(T)) == 0)
+			return false;
+		mValue = value;
+		mValid = true;
+		return true;
+	}
+
+	inline void Set(const T& value) { mValue = value; mValid = true; }
+	inline void Invalidate() { mValid = false; }
+	inline bool IsValid() const { return mValid; }
+	inline const T& Get() const { return mValue; }
+};
+
+struct StencilFuncState
+{
+	CompareFunc func;
+	int32_t ref;
+	uint32_t mask;
+};
+
+struct StencilOpState
+{
+	StencilOp stencilFail;
+	StencilOp depthFail;
+	StencilOp depthPass;
+};
+
+struct BlendEquationState
+{
+	BlendEquation rgb;
+	BlendEquation alpha;
+};
+
+struct BlendFuncState
+{
+	BlendFunc srcRGB;
+	BlendFunc dstRGB;
+	BlendFunc srcAlpha;
+	BlendFunc dstAlpha;
+};
+
+struct SampleCoverageState
+{
+	float value;
+	uint32_t invert;
+};
+
+struct ClipControlState
+{
+	Origin origin;
+	ClipControlDepthMode depth;
+};
+
+struct PolygonOffsetState
+{
+	float factor;
+	float units;
+};
+
+struct ImageBindingState
+{
+	uint32_t texture;
+	int32_t level;
+	uint32_t layered;
+	int32_t layer;
+	Access access;
+	TextureInternalFormat format;
+};
+
+// Size 0 for bindings of the whole buffer
+struct BufferRangeState
+{
+	int64_t offset;
+	int64_t size;
+	uint32_t buffer;
+	uint32_t base;
+};
+
+constexpr uint32_t CapabilityCount = 27;
+constexpr uint32_t PixelStoreParamCount = 16;
+constexpr uint32_t BufferTargetCount = 14;
+constexpr uint32_t TextureTargetCount = 11;
+constexpr uint32_t TextureUnitCount = 32;
+constexpr uint32_t ImageUnitCount = 8;
+constexpr uint32_t IndexedBufferTargetCount = 4;
+constexpr uint32_t IndexedBufferCount = 16;
+
+int32_t CapabilityToIndex(Capability cap);
+Capability IndexToCapability(uint32_t index);
+int32_t PixelStoreParamToIndex(PixelStoreParam pname);
+int32_t BufferTargetToIndex(BufferTarget target);
+int32_t TextureTargetToIndex(TextureTarget target);
+int32_t IndexedBufferTargetToIndex(BufferTarget target);
+
+// The element array binding is vertex array state, invalidate it after binding a vertex array
+struct BindingTable
+{
+	CachedValue<uint32_t> buffers[BufferTargetCount];
+	CachedValue<uint32_t> activeTextureUnit;
+	CachedValue<uint32_t> textures[TextureUnitCount][TextureTargetCount];
+	// Texture bound to the unit by BindTextureUnit()/BindTextures(), whatever its target
+	CachedValue<uint32_t> textureUnits[TextureUnitCount];
+	CachedValue<uint32_t> samplers[TextureUnitCount];
+	CachedValue<ImageBindingState> images[ImageUnitCount];
+	CachedValue<BufferRangeState> indexedBuffers[IndexedBufferTargetCount][IndexedBufferCount];
+};
+
+struct StateShadow
+{
+	CachedValue<bool> capabilities[CapabilityCount];
+	CachedValue<Box> viewport;
+	CachedValue<Box> scissorBox;
+	CachedValue<double> depthClearValue;
+	CachedValue<CompareFunc> depthFunc;
+	CachedValue<bool> depthMask;
+	CachedValue<Vec2d> depthRange;
+	CachedValue<int32_t> stencilClearValue;
+	CachedValue<StencilFuncState> stencilFunc[2];
+	CachedValue<uint32_t> stencilWriteMask[2];
+	CachedValue<StencilOpState> stencilOp[2];
+	CachedValue<Vec4f> blendColor;
+	CachedValue<BlendEquationState> blendEquation;
+	CachedValue<BlendFuncState> blendFunc;
+	CachedValue<Vec4f> clearColor;
+	CachedValue<Vec4b> colorWriteMask;
+	CachedValue<LogicOp> logicOpMode;
+	CachedValue<SampleCoverageState> sampleCoverage;
+	CachedValue<FrontFaceMode> frontFace;
+	CachedValue<Face> cullFace;
+	CachedValue<ClipControlState> clipControl;
+	CachedValue<float> lineWidth;
+	CachedValue<float> pointSize;
+	CachedValue<PolygonMode> polygonMode;
+	CachedValue<PolygonOffsetState> polygonOffset;
+	CachedValue<int32_t> pixelStore[PixelStoreParamCount];
+	BindingTable bindings;
+};
+
+// Opt-in shadow copy of the GL state of one context.
+// While a cache is current on the calling thread, the setters in State.h skip the
+// driver call when the value is already set. Call Resync() (or Invalidate()) after
+// code outside of GLUtil has changed state behind the cache's back.
+class StateCache
+{
+private:
+	StateShadow mShadow;
+	uint64_t mHits;
+	uint64_t mMisses;
+public:
+	StateCache(const StateCache&) = delete;
+	StateCache(StateCache&&) = delete;
+	StateCache& operator=(const StateCache&) = delete;
+	StateCache& operator=(StateCache&&) = delete;
+
+	StateCache();
+	~StateCache();
+
+	static StateCache* GetCurrent();
+	static void SetCurrent(StateCache* cache);
+	void MakeCurrent();
+
+	void Invalidate();
+	void Resync();
+
+	template<typename T>
+	bool Update(CachedValue<T>& cached, const typename std::decay<T>::type& value)
+	{
+		if (cached.Update(value)) {
+			mMisses++;
+			return true;
+		}
+		mHits++;
+		return false;
+	}
+
+	template<typename T>
+	bool UpdateFaces(CachedValue<T>* cached, Face face, const T& value)
+	{
+		bool changed = false;
+		if (face != Face::Back)
+			changed = cached[0].Update(value) || changed;
+		if (face != Face::Front)
+			changed = cached[1].Update(value) || changed;
+		if (changed)
+			mMisses++;
+		else
+			mHits++;
+		return changed;
+	}
+
+	// Updates the slots [first, first + count) and narrows them to the span that changed.
+	// Slots past cachedCount always count as changed. Returns false when none did.
+	template<typename T, typename F>
+	bool UpdateSlots(CachedValue<T>* cached, uint32_t cachedCount, uint32_t first, uint32_t count, F valueAt, uint32_t* changedBegin, uint32_t* changedEnd)
+	{
+		uint32_t begin = count;
+		uint32_t end = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			uint32_t slot = first + i;
+			if (slot >= cachedCount || cached[slot].Update(valueAt(i))) {
+				begin = std::min(begin, i);
+				end = i + 1;
+			}
+		}
+		if (begin >= end) {
+			mHits++;
+			return false;
+		}
+		mMisses++;
+		*changedBegin = begin;
+		*changedEnd = end;
+		return true;
+	}
+
+	// Returns nullptr for targets and units the table doesn't track
+	CachedValue<uint32_t>* GetBufferBinding(BufferTarget target);
+	CachedValue<uint32_t>* GetTextureBinding(uint32_t unit, TextureTarget target);
+	CachedValue<uint32_t>* GetTextureUnitBinding(uint32_t unit);
+	CachedValue<uint32_t>* GetSamplerBinding(uint32_t unit);
+	CachedValue<ImageBindingState>* GetImageBinding(uint32_t unit);
+	CachedValue<BufferRangeState>* GetIndexedBufferBinding(BufferTarget target, uint32_t index);
+	// Forgets the per target bindings of the unit
+	void InvalidateTextureUnit(uint32_t unit);
+
+	// Deleting an object unbinds it from the context
+	void ResetBuffer(uint32_t buffer);
+	void ResetTexture(uint32_t texture);
+	void ResetSampler(uint32_t sampler);
+
+	StateShadow& GetShadow();
+	const StateShadow& GetShadow() const;
+
+	uint64_t GetHits() const;
+	uint64_t GetMisses() const;
+	void ResetCounters();
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "Sync.h"
+
+#include <deque>
+
+namespace GLUtil {
+
+struct StreamAllocation
+{
+	void* ptr;
+	intptr_t offset;
+	intptr_t size;
+};
+
+// Persistently mapped buffer that hands out per-frame sub-allocations.
+// Every frame closed with EndFrame() is guarded by a fence and its bytes are only
+// reused once the GPU has passed that fence, so writes never need a map/unmap or
+// an implicit driver sync.
+class StreamRingBuffer
+{
+private:
+	struct Region
+	{
+		intptr_t end;
+		intptr_t used;
+		Fence fence;
+	};
+
+	Buffer mBuffer;
+	uint8_t* mMapped;
+	intptr_t mSize;
+	intptr_t mHead;
+	intptr_t mTail;
+	intptr_t mUsed;
+	intptr_t mFrameUsed;
+	std::deque<Region> mInFlight;
+
+	bool Reserve(intptr_t size, intptr_t alignment, intptr_t* offset);
+	bool Retire(bool wait);
+public:
+	StreamRingBuffer() = delete;
+	StreamRingBuffer(const StreamRingBuffer&) = delete;
+	StreamRingBuffer(StreamRingBuffer&&) = default;
+	StreamRingBuffer& operator=(const StreamRingBuffer&) = delete;
+	StreamRingBuffer& operator=(StreamRingBuffer&&) = default;
+
+	StreamRingBuffer(intptr_t size, Flags<BufferStorageFlags> extraFlags = Flags<BufferStorageFlags>());
+
+	StreamAllocation Allocate(intptr_t size, intptr_t alignment = 256);
+	StreamAllocation Write(const void* data, intptr_t size, intptr_t alignment = 256);
+	void EndFrame();
+	void Finish();
+
+	const Buffer& GetBuffer() const;
+	void* GetMapPointer() const;
+	intptr_t GetSize() const;
+	intptr_t GetUsed() const;
+	intptr_t GetFrameUsed() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
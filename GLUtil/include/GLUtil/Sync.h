@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Common.h"
+
+#include <vector>
+
+namespace GLUtil {
+
+enum class SyncWaitResult : uint32_t
+{
+	AlreadySignaled = 0x911A,
+	TimeoutExpired = 0x911B,
+	ConditionSatisfied = 0x911C,
+	WaitFailed = 0x911D
+};
+
+class Fence
+{
+private:
+	void* mSync;
+public:
+	Fence(const Fence&) = delete;
+	Fence& operator=(const Fence&) = delete;
+
+	Fence();
+	Fence(Fence&& other) noexcept;
+	Fence& operator=(Fence&& other) noexcept;
+	~Fence();
+
+	static Fence Create();
+
+	void Delete();
+
+	SyncWaitResult ClientWait(uint64_t timeout, bool flush = true) const;
+	// Blocks until the fence is signaled, returns false when the wait failed
+	bool Wait() const;
+	void ServerWait() const;
+	bool IsSignaled() const;
+
+	void* GetSync() const;
+	operator bool() const;
+};
+
+// Caps how many frames the CPU can queue ahead of the GPU.
+// Every frame closed with EndFrame() gets a fence, BeginFrame() only blocks when the
+// frame that used the same slot framesInFlight frames ago hasn't finished yet.
+// Memory written during frame GetFrame() can be reused once IsFrameComplete() says so.
+class FramePacer
+{
+private:
+	std::vector<Fence> mFences;
+	uint64_t mFrame;
+	uint64_t mCompleted;
+	uint64_t mStalls;
+
+	void Complete(uint64_t frame);
+public:
+	FramePacer() = delete;
+	FramePacer(const FramePacer&) = delete;
+	FramePacer(FramePacer&&) = default;
+	FramePacer& operator=(const FramePacer&) = delete;
+	FramePacer& operator=(FramePacer&&) = default;
+
+	FramePacer(uint32_t framesInFlight);
+
+	void BeginFrame();
+	void EndFrame();
+	void Finish();
+
+	// Frames that haven't been ended yet are never complete
+	bool IsFrameComplete(uint64_t frame);
+	bool WaitForFrame(uint64_t frame);
+
+	// Number of the frame being recorded, frames are numbered from 0
+	uint64_t GetFrame() const;
+	// GetFrame() % GetFramesInFlight(), for indexing per frame copies of resources
+	uint32_t GetFrameSlot() const;
+	uint32_t GetFramesInFlight() const;
+	// Frames below this number are known to be complete
+	uint64_t GetCompletedFrames() const;
+	// Number of times BeginFrame() had to block
+	uint64_t GetStalls() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
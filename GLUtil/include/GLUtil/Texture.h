@@ -5,6 +5,8 @@
 #include "Vec.h"
 #include "Sampler.h"
 
+#include <initializer_list>
+
 namespace GLUtil {
 
 enum class TextureInternalFormat : uint32_t
@@ -69,7 +71,7 @@ enum class TextureInternalFormat : uint32_t
 	RGBA32UI = 0x8D70,
 
 	RGB_DXT1 = 0x83F0,
-	SRGBA_DXT1 = 0x8C4C,
+	SRGB_DXT1 = 0x8C4C,
 	RGBA_DXT1 = 0x83F1,
 	SRGBA_DXT1 = 0x8C4D,
 	RGBA_DXT3 = 0x83F2,
@@ -272,16 +274,37 @@ uint32_t GetBoundTexture(TextureBinding binding);
 uint32_t GetBoundTexture(TextureTarget target);
 uint32_t GetActiveTextureUnit();
 void SetActiveTextureUnit(uint32_t unit);
-
-
-class Texture : GLObject
+void BindTexture(TextureTarget target, uint32_t texture);
+void BindTextureUnit(uint32_t unit, uint32_t texture);
+// Bind count textures to the units starting at first in one call, nullptr unbinds them.
+// With a StateCache current only the span of units that changed is rebound.
+void BindTextures(uint32_t first, int32_t count, const uint32_t* textures);
+void BindTextures(uint32_t first, std::initializer_list<uint32_t> textures);
+void BindImageTexture(uint32_t unit, uint32_t texture, int32_t level, bool layered, int32_t layer, Access access, TextureInternalFormat format);
+// Level 0, all layers, read and write access with the internal format of each texture
+void BindImageTextures(uint32_t first, int32_t count, const uint32_t* textures);
+void BindImageTextures(uint32_t first, std::initializer_list<uint32_t> textures);
+
+
+class Texture : public GLObject
 {
+private:
+	// Recorded on creation and by the Storage calls, so the getters don't query the driver.
+	// Textures adopted from a raw ID leave them unknown, mutable images aren't tracked.
+	TextureTarget mTarget;
+	TextureInternalFormat mFormat;
+	Vec3i mSize;
+	int32_t mLevels;
+	uint32_t mKnown;
+
+	void SetStorage(int32_t levels, TextureInternalFormat format, Vec3i size);
+	bool IsLevelKnown(int32_t level) const;
 public:
 	Texture() = delete;
 	Texture(const Texture&) = delete;
 	Texture(Texture&&) noexcept = default;
 	Texture& operator=(const Texture&) = delete;
-	Texture& operator=(Texture&&) noexcept = default;
+	Texture& operator=(Texture&&) noexcept;
 
 	Texture(TextureTarget target);
 	Texture(const char* filename, bool genMipmap = false);
@@ -289,6 +312,9 @@ public:
 	virtual ~Texture();
 
 	bool LoadFile(const char* filename, bool genMipmap = false);
+	// Allocates 8 bit storage, swizzle and filters for an image with 1 to 4 channels.
+	// Returns false for unsupported channel counts, format receives the upload format.
+	bool StorageImage2D(Vec2i size, int32_t channels, bool genMipmap, TextureBaseFormat* format);
 
 	Texture& Storage1D(int32_t levels, TextureInternalFormat format, int32_t width);
 	Texture& Storage2D(int32_t levels, TextureInternalFormat format, Vec2i size);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Common.h"
+#include "Math.h"
+#include "Texture.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace GLUtil {
+
+struct AtlasEntry
+{
+	// u0, v0, u1, v1 in the layer
+	Vec4f uvRect;
+	int32_t layer;
+	Vec2i offset;
+	Vec2i size;
+};
+
+// Packs many small images into the layers of one Tex2DArray with a skyline packer,
+// so sprites can share a single bind. Entries never move once added, running out of
+// layers reallocates the array and copies the existing layers over on the GPU.
+class TextureAtlas
+{
+private:
+	struct SkylineNode
+	{
+		int32_t x;
+		int32_t y;
+		int32_t width;
+	};
+
+	Texture mTexture;
+	TextureInternalFormat mFormat;
+	Vec2i mLayerSize;
+	int32_t mLayerCount;
+	int32_t mMaxLayers;
+	int32_t mLevels;
+	int32_t mPadding;
+	std::vector<std::vector<SkylineNode>> mSkylines;
+	std::unordered_map<uint64_t, AtlasEntry> mNamed;
+	int64_t mUsedArea;
+
+	bool FitSkyline(const std::vector<SkylineNode>& skyline, size_t index, Vec2i size, int32_t* y) const;
+	bool Pack(Vec2i size, int32_t* layer, Vec2i* offset);
+	void PlaceSkyline(std::vector<SkylineNode>& skyline, Vec2i offset, Vec2i size);
+	bool Grow();
+public:
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas(TextureAtlas&&) = default;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(TextureAtlas&&) = default;
+
+	// Padding is the empty border kept around every image against filtering bleed
+	TextureAtlas(Vec2i layerSize, TextureInternalFormat format = TextureInternalFormat::RGBA8, int32_t initialLayers = 1, int32_t maxLayers = 64, int32_t levels = 1, int32_t padding = 1);
+
+	// Layer is -1 when the image is larger than a layer or all layers are full
+	AtlasEntry Add(Vec2i size, TextureBaseFormat format, DataType type, const void* pixels);
+	// Loads the file as RGBA, adding the same file twice returns the existing entry
+	AtlasEntry AddFile(const char* filename);
+	const AtlasEntry* Find(uint64_t hash) const;
+
+	// After adding entries to atlases with more than one level
+	void GenerateMipmap();
+
+	const Texture& GetTexture() const;
+	Vec2i GetLayerSize() const;
+	int32_t GetLayerCount() const;
+	// Fraction of the allocated layers covered by entries
+	float GetOccupancy() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "Sync.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace GLUtil {
+
+struct TextureLoadState;
+
+using TextureLoadCallback = std::function<void(Texture& texture, bool success)>;
+
+// Handle to a texture queued on a TextureLoader
+class TextureHandle
+{
+private:
+	std::shared_ptr<TextureLoadState> mState;
+public:
+	TextureHandle();
+	TextureHandle(std::shared_ptr<TextureLoadState> state);
+
+	// True once the texture is uploaded or failed to load
+	bool IsReady() const;
+	bool Succeeded() const;
+
+	// The texture object exists right away, it has no storage until the upload is done
+	Texture& Get() const;
+	Vec2i GetSize() const;
+
+	bool IsValid() const;
+};
+
+// Decodes image files on a thread pool straight into a persistently mapped pixel
+// unpack buffer. The GL thread only records the upload from the buffer offset and
+// the mipmap generation in Update(), staging memory is reused once its fence passed.
+// Images that don't fit into the staging buffer are uploaded from client memory.
+class TextureLoader
+{
+private:
+	struct Slot
+	{
+		intptr_t offset;
+		intptr_t end;
+		intptr_t consumed;
+		bool released;
+	};
+
+	struct Batch
+	{
+		Fence fence;
+		std::vector<intptr_t> offsets;
+	};
+
+	ThreadPool& mPool;
+	Buffer mStaging;
+	uint8_t* mMapped;
+	intptr_t mSize;
+	intptr_t mHead;
+	intptr_t mTail;
+	intptr_t mUsed;
+	std::deque<Slot> mSlots;
+	mutable std::mutex mMutex;
+	std::vector<std::shared_ptr<TextureLoadState>> mDecoded;
+	std::deque<Batch> mInFlight;
+	std::atomic<uint32_t> mPending;
+
+	bool Reserve(intptr_t size, intptr_t* offset);
+	void Release(intptr_t offset);
+	void Retire();
+	void Decode(std::shared_ptr<TextureLoadState> state);
+public:
+	TextureLoader(const TextureLoader&) = delete;
+	TextureLoader(TextureLoader&&) = delete;
+	TextureLoader& operator=(const TextureLoader&) = delete;
+	TextureLoader& operator=(TextureLoader&&) = delete;
+
+	TextureLoader(ThreadPool& pool, intptr_t stagingSize = 64 << 20);
+	~TextureLoader();
+
+	// Must be called on the GL thread, the callback runs there during Update()
+	TextureHandle Load(const char* filename, bool genMipmap = false, TextureLoadCallback callback = nullptr);
+
+	// Uploads the images decoded so far, returns the number of loads still pending
+	uint32_t Update();
+	// Blocks until every queued load is done
+	void Finish();
+
+	uint32_t GetPendingCount() const;
+	intptr_t GetStagingUsed() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GLUtil {
+
+class ThreadPool
+{
+private:
+	std::vector<std::thread> mThreads;
+	std::deque<std::function<void()>> mTasks;
+	std::mutex mMutex;
+	std::condition_variable mCondition;
+	bool mStop;
+
+	void WorkerMain();
+public:
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	// 0 uses one thread less than the hardware supports, the caller being the last one
+	ThreadPool(uint32_t threadCount = 0);
+	~ThreadPool();
+
+	void Enqueue(std::function<void()> task);
+
+	// Splits [0, count) into chunks of at least grain elements and blocks until all are done.
+	// The calling thread works on chunks as well.
+	void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& func);
+
+	uint32_t GetThreadCount() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
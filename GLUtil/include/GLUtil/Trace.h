@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GLUtil {
+
+// Records CPU scopes and GPU timings of a capture window into per thread buffers and
+// writes them as Chrome trace event JSON, which chrome://tracing and the Perfetto UI load.
+// Recording is lock free: every thread appends to its own buffer, only the first event
+// of a thread takes a lock. Names must stay valid until EndCapture(), except for GPU
+// events whose names are copied.
+class TraceRecorder
+{
+public:
+	TraceRecorder() = delete;
+
+	// eventsPerThread events are kept per thread, later ones are dropped
+	static void BeginCapture(uint32_t eventsPerThread = 1 << 16);
+	// Returns false when the file couldn't be written
+	static bool EndCapture(const char* filename);
+	static bool IsCapturing();
+
+	// Nanoseconds on the trace clock
+	static uint64_t Now();
+	static void RecordCpu(const char* name, uint64_t start, uint64_t end);
+
+	// GPU events take GL_TIMESTAMP times, mapped onto the trace clock with the offset
+	// measured by SyncGpuClock() on the GL thread
+	static bool IsGpuClockSynced();
+	static void SyncGpuClock(uint64_t gpuTimestamp);
+	static void RecordGpu(const char* name, uint64_t gpuStart, uint64_t gpuEnd, uint32_t depth);
+
+	static uint64_t GetDroppedEvents();
+};
+
+class TraceScope
+{
+private:
+	const char* mName;
+	uint64_t mStart;
+public:
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+	TraceScope(const char* name);
+	~TraceScope();
+};
+
+} // namespace GLUtil
\ No newline at end of file
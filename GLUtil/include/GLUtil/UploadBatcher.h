@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Common.h"
+#include "Buffer.h"
+#include "StreamBuffer.h"
+
+#include <vector>
+
+namespace GLUtil {
+
+// Collects many small buffer updates in a persistently mapped staging ring instead of
+// one SubData call each. Flush() applies them with one glCopyNamedBufferSubData per run
+// of writes that are adjacent in both the staging and the destination buffer.
+// Overlapping writes to the same buffer are applied in the order they were made.
+class UploadBatcher
+{
+private:
+	struct Copy
+	{
+		uint32_t buffer;
+		uint32_t order;
+		intptr_t srcOffset;
+		intptr_t dstOffset;
+		intptr_t size;
+	};
+
+	StreamRingBuffer mStaging;
+	std::vector<Copy> mCopies;
+	std::vector<Copy> mMerged;
+	uint32_t mLastWriteCount;
+	uint32_t mLastCopyCount;
+
+	void Merge(Copy* begin, Copy* end);
+public:
+	UploadBatcher(const UploadBatcher&) = delete;
+	UploadBatcher(UploadBatcher&&) = default;
+	UploadBatcher& operator=(const UploadBatcher&) = delete;
+	UploadBatcher& operator=(UploadBatcher&&) = default;
+
+	UploadBatcher(intptr_t stagingSize = 16 * 1024 * 1024);
+
+	// Writes larger than the staging buffer go straight to the buffer after a Flush()
+	void Write(uint32_t buffer, intptr_t offset, intptr_t size, const void* data);
+	// Staging memory to fill before the next Flush(), nullptr when size doesn't fit
+	void* Allocate(uint32_t buffer, intptr_t offset, intptr_t size);
+	// Returns the number of copies issued
+	uint32_t Flush();
+
+	uint32_t GetPendingCount() const;
+	uint32_t GetLastWriteCount() const;
+	uint32_t GetLastCopyCount() const;
+	const StreamRingBuffer& GetStaging() const;
+};
+
+} // namespace GLUtil
\ No newline at end of file
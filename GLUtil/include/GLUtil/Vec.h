@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Simd.h"
+
 #include <cstddef>
 #include <cstdint>
 #include <cmath>
@@ -471,4 +473,56 @@ Vec<3, T> Cross(const Vec<3, T>& a, const Vec<3, T>& b)
 	return (Vec<3, T>(a.y, a.z, a.x) * Vec<3, T>(b.z, b.x, b.y)) - (Vec<3, T>(a.z, a.x, a.y) * Vec<3, T>(b.y, b.z, b.x));
 }
 
+// Cross product of the xyz components, w is zero
+template<typename T>
+Vec<4, T> Cross(const Vec<4, T>& a, const Vec<4, T>& b)
+{
+	return Vec<4, T>(Cross(Vec<3, T>(a.x, a.y, a.z), Vec<3, T>(b.x, b.y, b.z)), 0);
+}
+
+#if defined(GLUTIL_SIMD)
+
+#define GLUTIL_SIMD_VEC_OP(V, op, fn) \
+	inline V operator op(const V& a, const V& b) \
+	{ \
+		V r; \
+		Simd::Store(r.v, Simd::fn(Simd::Load(a.v), Simd::Load(b.v))); \
+		return r; \
+	} \
+	inline V& operator op##=(V& a, const V& b) \
+	{ \
+		Simd::Store(a.v, Simd::fn(Simd::Load(a.v), Simd::Load(b.v))); \
+		return a; \
+	}
+
+GLUTIL_SIMD_VEC_OP(Vec4f, +, Add)
+GLUTIL_SIMD_VEC_OP(Vec4f, -, Sub)
+GLUTIL_SIMD_VEC_OP(Vec4f, *, Mul)
+GLUTIL_SIMD_VEC_OP(Vec4f, /, Div)
+GLUTIL_SIMD_VEC_OP(Vec4d, +, Add)
+GLUTIL_SIMD_VEC_OP(Vec4d, -, Sub)
+GLUTIL_SIMD_VEC_OP(Vec4d, *, Mul)
+GLUTIL_SIMD_VEC_OP(Vec4d, /, Div)
+
+#undef GLUTIL_SIMD_VEC_OP
+
+inline float Dot(const Vec4f& a, const Vec4f& b)
+{
+	return Simd::HorizontalSum(Simd::Mul(Simd::Load(a.v), Simd::Load(b.v)));
+}
+
+inline double Dot(const Vec4d& a, const Vec4d& b)
+{
+	return Simd::HorizontalSum(Simd::Mul(Simd::Load(a.v), Simd::Load(b.v)));
+}
+
+inline Vec4f Cross(const Vec4f& a, const Vec4f& b)
+{
+	Vec4f r;
+	Simd::Store(r.v, Simd::Cross(Simd::Load(a.v), Simd::Load(b.v)));
+	return r;
+}
+
+#endif
+
 } // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include <GLUtil/AsyncCompile.h>
+
+#include <glad/gl.h>
+
+namespace GLUtil {
+
+enum class AsyncStage
+{
+	Compiling,
+	Linking,
+	Done,
+	Failed
+};
+
+struct AsyncProgramState
+{
+	Program program;
+	std::vector<Shader> shaders;
+	AsyncStage stage;
+	std::string infoLog;
+
+	AsyncProgramState() :
+		stage(AsyncStage::Compiling)
+	{}
+
+	void Fail(std::string log)
+	{
+		for (const Shader& shader : shaders)
+			program.DetachShader(shader);
+		shaders.clear();
+		program = Program(0u);
+		infoLog = std::move(log);
+		stage = AsyncStage::Failed;
+	}
+
+	// Returns true once the build is finished, only blocks on the driver when block is set
+	bool Advance(bool block)
+	{
+		if (stage == AsyncStage::Compiling) {
+			for (const Shader& shader : shaders) {
+				if (!block && !shader.IsCompletionReady())
+					return false;
+			}
+			for (const Shader& shader : shaders) {
+				if (!shader.IsCompiled()) {
+					Fail(shader.GetInfoLog());
+					return true;
+				}
+			}
+			program.LinkAsync();
+			stage = AsyncStage::Linking;
+		}
+
+		if (stage == AsyncStage::Linking) {
+			if (!block && !program.IsCompletionReady())
+				return false;
+			if (!program.IsLinked()) {
+				Fail(program.GetInfoLog());
+				return true;
+			}
+			for (const Shader& shader : shaders)
+				program.DetachShader(shader);
+			shaders.clear();
+			stage = AsyncStage::Done;
+		}
+
+		return true;
+	}
+};
+
+ProgramFuture::ProgramFuture()
+{}
+
+ProgramFuture::ProgramFuture(std::shared_ptr<AsyncProgramState> state) :
+	mState(std::move(state))
+{}
+
+bool ProgramFuture::IsReady() const
+{
+	return !mState || mState->Advance(false);
+}
+
+bool ProgramFuture::Succeeded() const
+{
+	return mState && mState->stage == AsyncStage::Done;
+}
+
+void ProgramFuture::Wait() const
+{
+	if (mState)
+		mState->Advance(true);
+}
+
+Program* ProgramFuture::Get() const
+{
+	if (!mState)
+		return nullptr;
+	Wait();
+	return &mState->program;
+}
+
+const std::string& ProgramFuture::GetInfoLog() const
+{
+	static const std::string empty;
+	return mState ? mState->infoLog : empty;
+}
+
+bool ProgramFuture::IsValid() const
+{
+	return mState != nullptr;
+}
+
+ShaderCompiler::ShaderCompiler()
+{}
+
+ShaderCompiler::~ShaderCompiler()
+{}
+
+void ShaderCompiler::SetMaxThreads(uint32_t count)
+{
+	if (GLAD_GL_KHR_parallel_shader_compile) {
+		GLUTIL_GL_CALL(glMaxShaderCompilerThreadsKHR(count));
+	} else if (GLAD_GL_ARB_parallel_shader_compile) {
+		GLUTIL_GL_CALL(glMaxShaderCompilerThreadsARB(count));
+	}
+}
+
+bool ShaderCompiler::IsParallelSupported()
+{
+	return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
+// Every shader of the program is submitted before any status is queried,
+// the program is attached up front so linking only waits on the compile results
+ProgramFuture ShaderCompiler::Submit(const ProgramSource* sources, uint32_t count, const char* defines)
+{
+	auto state = std::make_shared<AsyncProgramState>();
+	state->shaders.reserve(count);
+	for (uint32_t i = 0; i < count; i++) {
+		Shader shader(sources[i].type);
+		shader.Source(sources[i].source, defines);
+		shader.CompileAsync();
+		state->program.AttachShader(shader);
+		state->shaders.push_back(std::move(shader));
+	}
+
+	mPending.push_back(state);
+	return ProgramFuture(std::move(state));
+}
+
+ProgramFuture ShaderCompiler::Submit(std::initializer_list<ProgramSource> sources, const char* defines)
+{
+	return Submit(sources.begin(), static_cast<uint32_t>(sources.size()), defines);
+}
+
+uint32_t ShaderCompiler::Poll()
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < mPending.size(); i++) {
+		if (!mPending[i]->Advance(false))
+			mPending[kept++] = std::move(mPending[i]);
+	}
+	mPending.resize(kept);
+	return static_cast<uint32_t>(kept);
+}
+
+// Wait on everything in submission order, the later builds have had the most time
+void ShaderCompiler::WaitAll()
+{
+	for (const auto& state : mPending)
+		state->Advance(true);
+	mPending.clear();
+}
+
+uint32_t ShaderCompiler::GetPendingCount() const
+{
+	return static_cast<uint32_t>(mPending.size());
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include <GLUtil/BatchTransform.h>
+
+#include <cstring>
+
+namespace GLUtil {
+
+static const size_t BatchGrain = 4096;
+
+template<typename Func>
+static void Dispatch(size_t count, ThreadPool* pool, const Func& func)
+{
+	if (pool && count > BatchGrain)
+		pool->ParallelFor(count, BatchGrain, func);
+	else
+		func(0, count);
+}
+
+struct SoAOutput
+{
+	float* x;
+	float* y;
+	float* z;
+
+#if defined(GLUTIL_SIMD)
+	void Store(size_t i, Simd::Float4 rx, Simd::Float4 ry, Simd::Float4 rz) const
+	{
+		Simd::Store(x + i, rx);
+		Simd::Store(y + i, ry);
+		Simd::Store(z + i, rz);
+	}
+#endif
+
+	void Store(size_t i, float rx, float ry, float rz) const
+	{
+		x[i] = rx;
+		y[i] = ry;
+		z[i] = rz;
+	}
+};
+
+struct StridedOutput
+{
+	uint8_t* out;
+	size_t stride;
+
+#if defined(GLUTIL_SIMD)
+	void Store(size_t i, Simd::Float4 rx, Simd::Float4 ry, Simd::Float4 rz) const
+	{
+		float lanes[3][4];
+		Simd::Store(lanes[0], rx);
+		Simd::Store(lanes[1], ry);
+		Simd::Store(lanes[2], rz);
+		for (size_t l = 0; l < 4; l++)
+			Store(i + l, lanes[0][l], lanes[1][l], lanes[2][l]);
+	}
+#endif
+
+	void Store(size_t i, float rx, float ry, float rz) const
+	{
+		float v[3] = { rx, ry, rz };
+		memcpy(out + i * stride, v, sizeof(v));
+	}
+};
+
+template<typename Output>
+static void TransformPointsRange(const Mat4f& m, const float* x, const float* y, const float* z, size_t begin, size_t end, const Output& out)
+{
+	size_t i = begin;
+#if defined(GLUTIL_SIMD)
+	Simd::Float4 c[4][3];
+	for (unsigned col = 0; col < 4; col++) {
+		for (unsigned row = 0; row < 3; row++)
+			c[col][row] = Simd::Splat(m.m[col][row]);
+	}
+	for (; i + 4 <= end; i += 4) {
+		Simd::Float4 px = Simd::Load(x + i);
+		Simd::Float4 py = Simd::Load(y + i);
+		Simd::Float4 pz = Simd::Load(z + i);
+		Simd::Float4 r[3];
+		for (unsigned row = 0; row < 3; row++)
+			r[row] = Simd::MulAdd(c[0][row], px, Simd::MulAdd(c[1][row], py, Simd::MulAdd(c[2][row], pz, c[3][row])));
+		out.Store(i, r[0], r[1], r[2]);
+	}
+#endif
+	for (; i < end; i++) {
+		float r[3];
+		for (unsigned row = 0; row < 3; row++)
+			r[row] = m.m[0][row] * x[i] + m.m[1][row] * y[i] + m.m[2][row] * z[i] + m.m[3][row];
+		out.Store(i, r[0], r[1], r[2]);
+	}
+}
+
+void TransformPoints(const Mat4f& m, const float* x, const float* y, const float* z, size_t count, float* outX, float* outY, float* outZ, ThreadPool* pool)
+{
+	SoAOutput out = { outX, outY, outZ };
+	Dispatch(count, pool, [&](size_t begin, size_t end) {
+		TransformPointsRange(m, x, y, z, begin, end, out);
+	});
+}
+
+void TransformPoints(const Mat4f& m, const float* x, const float* y, const float* z, size_t count, void* out, size_t outStride, ThreadPool* pool)
+{
+	StridedOutput strided = { static_cast<uint8_t*>(out), outStride };
+	Dispatch(count, pool, [&](size_t begin, size_t end) {
+		TransformPointsRange(m, x, y, z, begin, end, strided);
+	});
+}
+
+void MultiplyMatrices(const Mat4f& parent, const Mat4f* matrices, size_t count, Mat4f* out, ThreadPool* pool)
+{
+	Dispatch(count, pool, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			out[i] = parent * matrices[i];
+	});
+}
+
+// Columns of the inverse transpose are the cross products of the other two columns over the determinant
+static void NormalMatrix(const Mat4f& m, Mat3x4f& out)
+{
+	Vec3f c0(m.m[0][0], m.m[0][1], m.m[0][2]);
+	Vec3f c1(m.m[1][0], m.m[1][1], m.m[1][2]);
+	Vec3f c2(m.m[2][0], m.m[2][1], m.m[2][2]);
+	Vec3f n0 = Cross(c1, c2);
+	float invDet = 1.0f / Dot(c0, n0);
+	out.rows[0] = Vec4f(n0 * invDet, 0.0f);
+	out.rows[1] = Vec4f(Cross(c2, c0) * invDet, 0.0f);
+	out.rows[2] = Vec4f(Cross(c0, c1) * invDet, 0.0f);
+}
+
+static void NormalMatricesRange(const Mat4f* matrices, size_t begin, size_t end, Mat3x4f* out)
+{
+	size_t i = begin;
+#if defined(GLUTIL_SIMD)
+	// Four matrices per register, lane l holding element [col][row] of matrix i + l
+	for (; i + 4 <= end; i += 4) {
+		float lanes[3][3][4];
+		for (unsigned l = 0; l < 4; l++) {
+			for (unsigned col = 0; col < 3; col++) {
+				for (unsigned row = 0; row < 3; row++)
+					lanes[col][row][l] = matrices[i + l].m[col][row];
+			}
+		}
+
+		Simd::Float4 c[3][3];
+		for (unsigned col = 0; col < 3; col++) {
+			for (unsigned row = 0; row < 3; row++)
+				c[col][row] = Simd::Load(lanes[col][row]);
+		}
+
+		Simd::Float4 n[3][3];
+		for (unsigned col = 0; col < 3; col++) {
+			const Simd::Float4* a = c[(col + 1) % 3];
+			const Simd::Float4* b = c[(col + 2) % 3];
+			n[col][0] = Simd::Sub(Simd::Mul(a[1], b[2]), Simd::Mul(a[2], b[1]));
+			n[col][1] = Simd::Sub(Simd::Mul(a[2], b[0]), Simd::Mul(a[0], b[2]));
+			n[col][2] = Simd::Sub(Simd::Mul(a[0], b[1]), Simd::Mul(a[1], b[0]));
+		}
+
+		Simd::Float4 det = Simd::MulAdd(c[0][0], n[0][0], Simd::MulAdd(c[0][1], n[0][1], Simd::Mul(c[0][2], n[0][2])));
+		Simd::Float4 invDet = Simd::Div(Simd::Splat(1.0f), det);
+
+		for (unsigned col = 0; col < 3; col++) {
+			for (unsigned row = 0; row < 3; row++)
+				Simd::Store(lanes[col][row], Simd::Mul(n[col][row], invDet));
+		}
+		for (unsigned l = 0; l < 4; l++) {
+			for (unsigned col = 0; col < 3; col++)
+				out[i + l].rows[col] = Vec4f(lanes[col][0][l], lanes[col][1][l], lanes[col][2][l], 0.0f);
+		}
+	}
+#endif
+	for (; i < end; i++)
+		NormalMatrix(matrices[i], out[i]);
+}
+
+void ComputeNormalMatrices(const Mat4f* matrices, size_t count, Mat3x4f* out, ThreadPool* pool)
+{
+	Dispatch(count, pool, [&](size_t begin, size_t end) {
+		NormalMatricesRange(matrices, begin, end, out);
+	});
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include <GLUtil/BlockLayout.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace GLUtil {
+
+// Ranges closer than this are uploaded together, a small copy is cheaper than another call
+static const int32_t DirtyMergeGap = 64;
+static const size_t MaxDirtyRanges = 16;
+
+static int32_t AlignUp(int32_t value, int32_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// Vectors have one column, scalars one row as well
+static bool GetTypeShape(DataType type, int32_t* columns, int32_t* rows, int32_t* scalarSize)
+{
+	switch (type) {
+		case DataType::Float: case DataType::Int: case DataType::UnsignedInt: case DataType::Bool:
+			*columns = 1; *rows = 1; *scalarSize = 4; return true;
+		case DataType::FloatVec2: case DataType::IntVec2: case DataType::UnsignedIntVec2: case DataType::BoolVec2:
+			*columns = 1; *rows = 2; *scalarSize = 4; return true;
+		case DataType::FloatVec3: case DataType::IntVec3: case DataType::UnsignedIntVec3: case DataType::BoolVec3:
+			*columns = 1; *rows = 3; *scalarSize = 4; return true;
+		case DataType::FloatVec4: case DataType::IntVec4: case DataType::UnsignedIntVec4: case DataType::BoolVec4:
+			*columns = 1; *rows = 4; *scalarSize = 4; return true;
+		case DataType::Double: *columns = 1; *rows = 1; *scalarSize = 8; return true;
+		case DataType::DoubleVec2: *columns = 1; *rows = 2; *scalarSize = 8; return true;
+		case DataType::DoubleVec3: *columns = 1; *rows = 3; *scalarSize = 8; return true;
+		case DataType::DoubleVec4: *columns = 1; *rows = 4; *scalarSize = 8; return true;
+		case DataType::FloatMat2: *columns = 2; *rows = 2; *scalarSize = 4; return true;
+		case DataType::FloatMat3: *columns = 3; *rows = 3; *scalarSize = 4; return true;
+		case DataType::FloatMat4: *columns = 4; *rows = 4; *scalarSize = 4; return true;
+		case DataType::FloatMat2x3: *columns = 2; *rows = 3; *scalarSize = 4; return true;
+		case DataType::FloatMat2x4: *columns = 2; *rows = 4; *scalarSize = 4; return true;
+		case DataType::FloatMat3x2: *columns = 3; *rows = 2; *scalarSize = 4; return true;
+		case DataType::FloatMat3x4: *columns = 3; *rows = 4; *scalarSize = 4; return true;
+		case DataType::FloatMat4x2: *columns = 4; *rows = 2; *scalarSize = 4; return true;
+		case DataType::FloatMat4x3: *columns = 4; *rows = 3; *scalarSize = 4; return true;
+		case DataType::DoubleMat2: *columns = 2; *rows = 2; *scalarSize = 8; return true;
+		case DataType::DoubleMat3: *columns = 3; *rows = 3; *scalarSize = 8; return true;
+		case DataType::DoubleMat4: *columns = 4; *rows = 4; *scalarSize = 8; return true;
+		case DataType::DoubleMat2x3: *columns = 2; *rows = 3; *scalarSize = 8; return true;
+		case DataType::DoubleMat2x4: *columns = 2; *rows = 4; *scalarSize = 8; return true;
+		case DataType::DoubleMat3x2: *columns = 3; *rows = 2; *scalarSize = 8; return true;
+		case DataType::DoubleMat3x4: *columns = 3; *rows = 4; *scalarSize = 8; return true;
+		case DataType::DoubleMat4x2: *columns = 4; *rows = 2; *scalarSize = 8; return true;
+		case DataType::DoubleMat4x3: *columns = 4; *rows = 3; *scalarSize = 8; return true;
+		default:
+			return false;
+	}
+}
+
+BlockLayout::BlockLayout(BlockLayoutRule rule) :
+	mRule(rule), mSize(0), mAlignment(rule == BlockLayoutRule::Std140 ? 16 : 4)
+{}
+
+// Vectors align to 2 or 4 components, matrices and arrays are laid out like arrays of
+// their columns or elements. std140 rounds the stride of those up to a vec4, std430 doesn't.
+BlockLayout& BlockLayout::Add(const char* name, DataType type, int32_t arraySize)
+{
+	int32_t columns, rows, scalarSize;
+	if (!GetTypeShape(type, &columns, &rows, &scalarSize))
+		return *this;
+
+	int32_t alignment = scalarSize * (rows == 1 ? 1 : (rows == 2 ? 2 : 4));
+	int32_t size = scalarSize * rows;
+	bool arrayLike = columns > 1 || arraySize > 0;
+	if (arrayLike && mRule == BlockLayoutRule::Std140)
+		alignment = AlignUp(alignment, 16);
+
+	BlockMember member;
+	member.hash = HashString(name);
+	member.type = type;
+	member.arraySize = arraySize;
+	member.matrixStride = columns > 1 ? alignment : 0;
+	member.rowMajor = false;
+	int32_t elementSize = columns > 1 ? columns * alignment : (arrayLike ? alignment : size);
+	member.arrayStride = arraySize > 0 ? elementSize : 0;
+	member.offset = AlignUp(mSize, alignment);
+
+	mSize = member.offset + elementSize * std::max(arraySize, 1);
+	if (arrayLike)
+		mSize = AlignUp(mSize, alignment);
+	mAlignment = std::max(mAlignment, alignment);
+
+	mLookup[member.hash] = static_cast<uint32_t>(mMembers.size());
+	mMembers.push_back(member);
+	return *this;
+}
+
+bool BlockLayout::Build(const ProgramReflection& reflection, ProgramInterface interface, uint64_t blockHash)
+{
+	Clear();
+
+	bool storage = interface == ProgramInterface::ShaderStorageBlock;
+	const ReflectedBlock* block = storage ? reflection.FindStorageBlock(blockHash) : reflection.FindUniformBlock(blockHash);
+	if (!block)
+		return false;
+
+	const std::vector<ReflectedUniform>& variables = storage ? reflection.GetBufferVariables() : reflection.GetUniforms();
+	for (const ReflectedUniform& variable : variables) {
+		if (variable.blockIndex != static_cast<int32_t>(block->index))
+			continue;
+
+		BlockMember member;
+		member.hash = variable.hash;
+		member.type = variable.type;
+		member.offset = variable.offset;
+		member.arraySize = variable.arraySize > 1 ? variable.arraySize : 0;
+		member.arrayStride = variable.arrayStride;
+		member.matrixStride = variable.matrixStride;
+		member.rowMajor = variable.rowMajor;
+
+		uint32_t slot = static_cast<uint32_t>(mMembers.size());
+		mMembers.push_back(member);
+		mLookup[member.hash] = slot;
+
+		// "Block.member" and "member[0]" can be looked up as "member" as well
+		std::string name = variable.name;
+		size_t dot = name.find('.');
+		if (dot != std::string::npos)
+			name = name.substr(dot + 1);
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+			name.resize(name.size() - 3);
+		mLookup.emplace(HashString(name.c_str()), slot);
+	}
+
+	mSize = block->dataSize;
+	return true;
+}
+
+void BlockLayout::Clear()
+{
+	mMembers.clear();
+	mLookup.clear();
+	mSize = 0;
+	mAlignment = mRule == BlockLayoutRule::Std140 ? 16 : 4;
+}
+
+const BlockMember* BlockLayout::Find(uint64_t hash) const
+{
+	auto it = mLookup.find(hash);
+	return it != mLookup.end() ? &mMembers[it->second] : nullptr;
+}
+
+const std::vector<BlockMember>& BlockLayout::GetMembers() const
+{
+	return mMembers;
+}
+
+BlockLayoutRule BlockLayout::GetRule() const
+{
+	return mRule;
+}
+
+int32_t BlockLayout::GetSize() const
+{
+	return AlignUp(mSize, mAlignment);
+}
+
+BlockMirror::BlockMirror(BlockLayout layout) :
+	mLayout(std::move(layout)), mData(mLayout.GetSize(), 0)
+{
+	MarkDirty();
+}
+
+// Keeps the ranges sorted, merges overlapping and nearby ones
+void BlockMirror::AddDirty(int32_t begin, int32_t end)
+{
+	auto it = std::lower_bound(mDirty.begin(), mDirty.end(), begin, [](const Range& range, int32_t value) { return range.end + DirtyMergeGap < value; });
+	auto last = it;
+	while (last != mDirty.end() && last->begin <= end + DirtyMergeGap) {
+		begin = std::min(begin, last->begin);
+		end = std::max(end, last->end);
+		++last;
+	}
+	it = mDirty.erase(it, last);
+	mDirty.insert(it, { begin, end });
+
+	if (mDirty.size() > MaxDirtyRanges) {
+		Range all = { mDirty.front().begin, mDirty.back().end };
+		mDirty.assign(1, all);
+	}
+}
+
+bool BlockMirror::Set(uint64_t hash, uint32_t index, const void* data, uint32_t size)
+{
+	const BlockMember* member = mLayout.Find(hash);
+	if (!member || size != GetDataTypeSize(member->type))
+		return false;
+	if (index > 0 && index >= static_cast<uint32_t>(member->arraySize))
+		return false;
+
+	int32_t columns, rows, scalarSize;
+	if (!GetTypeShape(member->type, &columns, &rows, &scalarSize))
+		return false;
+
+	const uint8_t* src = static_cast<const uint8_t*>(data);
+	int32_t offset = member->offset + static_cast<int32_t>(index) * member->arrayStride;
+
+	// Row-major matrices are transposed one row at a time
+	if (columns > 1 && member->rowMajor) {
+		uint8_t row[4 * 8];
+		int32_t rowSize = columns * scalarSize;
+		for (int32_t r = 0; r < rows; r++) {
+			int32_t rowOffset = offset + r * member->matrixStride;
+			if (rowOffset + rowSize > static_cast<int32_t>(mData.size()))
+				return false;
+			for (int32_t c = 0; c < columns; c++)
+				memcpy(row + c * scalarSize, src + (c * rows + r) * scalarSize, scalarSize);
+			Write(rowOffset, row, rowSize);
+		}
+		return true;
+	}
+
+	int32_t columnSize = rows * scalarSize;
+	int32_t columnStride = columns > 1 ? member->matrixStride : columnSize;
+	for (int32_t i = 0; i < columns; i++) {
+		int32_t columnOffset = offset + i * columnStride;
+		if (columnOffset + columnSize > static_cast<int32_t>(mData.size()))
+			return false;
+		Write(columnOffset, src + i * columnSize, columnSize);
+	}
+	return true;
+}
+
+void BlockMirror::Write(int32_t offset, const void* data, int32_t size)
+{
+	if (offset < 0 || size <= 0 || offset + size > static_cast<int32_t>(mData.size()))
+		return;
+	uint8_t* dst = mData.data() + offset;
+	if (memcmp(dst, data, size) == 0)
+		return;
+	memcpy(dst, data, size);
+	AddDirty(offset, offset + size);
+}
+
+void BlockMirror::MarkDirty()
+{
+	mDirty.clear();
+	if (!mData.empty())
+		mDirty.push_back({ 0, static_cast<int32_t>(mData.size()) });
+}
+
+void BlockMirror::Flush(Buffer& buffer, intptr_t offset)
+{
+	for (const Range& range : mDirty)
+		buffer.SubData(offset + range.begin, range.end - range.begin, mData.data() + range.begin);
+	mDirty.clear();
+}
+
+void BlockMirror::Flush(void* mapped)
+{
+	uint8_t* dst = static_cast<uint8_t*>(mapped);
+	for (const Range& range : mDirty)
+		memcpy(dst + range.begin, mData.data() + range.begin, range.end - range.begin);
+	mDirty.clear();
+}
+
+bool BlockMirror::IsDirty() const
+{
+	return !mDirty.empty();
+}
+
+uint32_t BlockMirror::GetDirtyRangeCount() const
+{
+	return static_cast<uint32_t>(mDirty.size());
+}
+
+const void* BlockMirror::GetData() const
+{
+	return mData.data();
+}
+
+int32_t BlockMirror::GetSize() const
+{
+	return static_cast<int32_t>(mData.size());
+}
+
+const BlockLayout& BlockMirror::GetLayout() const
+{
+	return mLayout;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include <GLUtil/Buffer.h>
+#include <GLUtil/StateCache.h>
 
 #include <GLUtil/Common.h>
 
 #include <glad/gl.h>
 
+#include <utility>
+
 #define BUFFER_BIND BufferBind _bind(target, *this)
 #define ENUM(e) static_cast<GLenum>(e)
 
@@ -81,10 +84,22 @@ BufferTarget BufferBindingToTarget(BufferBinding binding)
 	}
 }
 
+static CachedValue<uint32_t>* GetCachedBinding(BufferTarget target)
+{
+	StateCache* cache = StateCache::GetCurrent();
+	return cache ? cache->GetBufferBinding(target) : nullptr;
+}
+
 uint32_t GetBoundBuffer(BufferBinding binding)
 {
+	CachedValue<uint32_t>* cached = GetCachedBinding(BufferBindingToTarget(binding));
+	if (cached && cached->IsValid())
+		return cached->Get();
+
 	uint32_t buffer = 0;
 	GLUTIL_GL_CALL(glGetIntegerv(ENUM(binding), reinterpret_cast<GLint*>(&buffer)));
+	if (cached)
+		cached->Set(buffer);
 	return buffer;
 }
 
@@ -95,19 +110,99 @@ uint32_t GetBoundBuffer(BufferTarget target)
 
 void BindBuffer(BufferTarget target, uint32_t buffer)
 {
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		CachedValue<uint32_t>* cached = cache->GetBufferBinding(target);
+		if (cached && !cache->Update(*cached, buffer))
+			return;
+	}
 	GLUTIL_GL_CALL(glBindBuffer(ENUM(target), buffer));
 }
 
+// Indexed binds also replace the generic binding of the target, even when the
+// indexed binding is already set and only the generic one needs a bind
 void BindBufferBase(BufferTarget target, uint32_t index, uint32_t buffer)
 {
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		CachedValue<BufferRangeState>* cached = cache->GetIndexedBufferBinding(target, index);
+		if (cached && !cache->Update(*cached, { 0, 0, buffer, 1 })) {
+			BindBuffer(target, buffer);
+			return;
+		}
+	}
+	if (CachedValue<uint32_t>* cached = GetCachedBinding(target))
+		cached->Set(buffer);
 	GLUTIL_GL_CALL(glBindBufferBase(ENUM(target), index, buffer));
 }
 
 void BindBufferRange(BufferTarget target, uint32_t index, uint32_t buffer, intptr_t offset, intptr_t size)
 {
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		CachedValue<BufferRangeState>* cached = cache->GetIndexedBufferBinding(target, index);
+		if (cached && !cache->Update(*cached, { offset, size, buffer, 0 })) {
+			BindBuffer(target, buffer);
+			return;
+		}
+	}
+	if (CachedValue<uint32_t>* cached = GetCachedBinding(target))
+		cached->Set(buffer);
 	GLUTIL_GL_CALL(glBindBufferRange(ENUM(target), index, buffer, offset, size));
 }
 
+static CachedValue<BufferRangeState>* GetIndexedBindings(StateCache* cache, BufferTarget target, uint32_t* count)
+{
+	CachedValue<BufferRangeState>* cached = cache->GetIndexedBufferBinding(target, 0);
+	*count = cached ? IndexedBufferCount : 0;
+	return cached;
+}
+
+// Unlike the single binds, the multi binds leave the generic binding alone
+void BindBuffersBase(BufferTarget target, uint32_t first, int32_t count, const uint32_t* buffers)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		uint32_t cachedCount, begin, end;
+		CachedValue<BufferRangeState>* cached = GetIndexedBindings(cache, target, &cachedCount);
+		auto valueAt = [&](uint32_t i) { return BufferRangeState{ 0, 0, buffers ? buffers[i] : 0, 1 }; };
+		if (!cache->UpdateSlots(cached, cachedCount, first, count, valueAt, &begin, &end))
+			return;
+		first += begin;
+		count = end - begin;
+		if (buffers)
+			buffers += begin;
+	}
+	GLUTIL_GL_CALL(glBindBuffersBase(ENUM(target), first, count, buffers));
+}
+
+void BindBuffersBase(BufferTarget target, uint32_t first, std::initializer_list<uint32_t> buffers)
+{
+	BindBuffersBase(target, first, static_cast<int32_t>(buffers.size()), buffers.begin());
+}
+
+void BindBuffersRange(BufferTarget target, uint32_t first, int32_t count, const uint32_t* buffers, const intptr_t* offsets, const intptr_t* sizes)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		uint32_t cachedCount, begin, end;
+		CachedValue<BufferRangeState>* cached = GetIndexedBindings(cache, target, &cachedCount);
+		auto valueAt = [&](uint32_t i) {
+			return buffers ? BufferRangeState{ offsets[i], sizes[i], buffers[i], 0 } : BufferRangeState{ 0, 0, 0, 1 };
+		};
+		if (!cache->UpdateSlots(cached, cachedCount, first, count, valueAt, &begin, &end))
+			return;
+		first += begin;
+		count = end - begin;
+		if (buffers) {
+			buffers += begin;
+			offsets += begin;
+			sizes += begin;
+		}
+	}
+	GLUTIL_GL_CALL(glBindBuffersRange(ENUM(target), first, count, buffers, offsets, sizes));
+}
+
+void CopyBufferSubData(uint32_t readBuffer, uint32_t writeBuffer, intptr_t readOffset, intptr_t writeOffset, intptr_t size)
+{
+	GLUTIL_GL_CALL(glCopyNamedBufferSubData(readBuffer, writeBuffer, readOffset, writeOffset, size));
+}
+
 BufferBind::BufferBind(BufferTarget target, uint32_t buffer) :
 	mTarget(target), mPrev(GetBoundBuffer(target))
 {
@@ -119,15 +214,29 @@ BufferBind::~BufferBind()
 	BindBuffer(mTarget, mPrev);
 }
 
-Buffer::Buffer()
+// The initial state of a buffer object
+Buffer::Buffer() :
+	mSize(0), mStorageFlags(), mUsage(BufferUsage::StaticDraw), mImmutable(false), mKnown(true)
 {
 	GLUTIL_GL_CALL(glCreateBuffers(1, GetIDPtr()));
 }
 
 Buffer::Buffer(uint32_t buffer) :
-	GLObject(buffer)
+	GLObject(buffer), mSize(0), mStorageFlags(), mUsage(BufferUsage::StaticDraw), mImmutable(false), mKnown(false)
 {}
 
+// The object IDs are swapped, the metadata has to follow them
+Buffer& Buffer::operator=(Buffer&& other) noexcept
+{
+	GLObject::operator=(std::move(other));
+	std::swap(mSize, other.mSize);
+	std::swap(mStorageFlags, other.mStorageFlags);
+	std::swap(mUsage, other.mUsage);
+	std::swap(mImmutable, other.mImmutable);
+	std::swap(mKnown, other.mKnown);
+	return *this;
+}
+
 Buffer::Buffer(intptr_t size, const void* data, Flags<BufferStorageFlags> flags) : 
 	Buffer()
 {
@@ -143,6 +252,8 @@ Buffer::Buffer(intptr_t size, const void* data, BufferUsage usage) :
 Buffer::~Buffer()
 {
 	if (*this) {
+		if (StateCache* cache = StateCache::GetCurrent())
+			cache->ResetBuffer(*this);
 		GLUTIL_GL_CALL(glDeleteBuffers(1, GetIDPtr()));
 	}
 }
@@ -150,12 +261,25 @@ Buffer::~Buffer()
 Buffer& Buffer::Storage(intptr_t size, const void* data, Flags<BufferStorageFlags> flags)
 {
 	GLUTIL_GL_CALL(glNamedBufferStorage(*this, size, data, flags));
+	// Fails on immutable storage
+	if (!mImmutable) {
+		mSize = size;
+		mStorageFlags = flags;
+		mUsage = BufferUsage::DynamicDraw;
+		mImmutable = true;
+	}
 	return *this;
 }
 
 Buffer& Buffer::Data(intptr_t size, const void* data, BufferUsage usage)
 {
 	GLUTIL_GL_CALL(glNamedBufferData(*this, size, data, ENUM(usage)));
+	// Fails on immutable storage
+	if (!mImmutable) {
+		mSize = size;
+		mStorageFlags = { BufferStorageFlags::MapRead, BufferStorageFlags::MapWrite, BufferStorageFlags::DynamicStorage };
+		mUsage = usage;
+	}
 	return *this;
 }
 
@@ -165,6 +289,12 @@ Buffer& Buffer::SubData(intptr_t offset, intptr_t size, const void* data)
 	return *this;
 }
 
+Buffer& Buffer::CopySubData(uint32_t readBuffer, intptr_t readOffset, intptr_t writeOffset, intptr_t size)
+{
+	CopyBufferSubData(readBuffer, *this, readOffset, writeOffset, size);
+	return *this;
+}
+
 void* Buffer::Map(BufferAccess access)
 {
 	GLUTIL_GL_CALL(void* ptr = glMapNamedBuffer(*this, ENUM(access)));
@@ -245,6 +375,8 @@ Flags<BufferAccessFlags> Buffer::GetAccessFlags() const
 
 bool Buffer::IsImmutableStorage() const
 {
+	if (mKnown)
+		return mImmutable;
 	return GetPropI(BufferProp::ImmutableStorage) == GL_TRUE;
 }
 
@@ -265,16 +397,22 @@ int64_t Buffer::GetMapOffset() const
 
 int64_t Buffer::GetSize() const
 {
+	if (mKnown)
+		return mSize;
 	return GetPropI64(BufferProp::Size);
 }
 
 Flags<BufferStorageFlags> Buffer::GetStorageFlags() const
 {
+	if (mKnown)
+		return mStorageFlags;
 	return GetPropI(BufferProp::StorageFlags);
 }
 
 BufferUsage Buffer::GetUsage() const
 {
+	if (mKnown)
+		return mUsage;
 	return static_cast<BufferUsage>(GetPropI(BufferProp::Usage));
 }
 
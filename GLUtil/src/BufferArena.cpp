@@ -0,0 +1,355 @@
+#include <GLUtil/BufferArena.h>
+
+#include <algorithm>
+
+namespace GLUtil {
+
+static uint32_t FindLastSet(uint32_t value)
+{
+	uint32_t bit = 0;
+	while (value >>= 1)
+		bit++;
+	return bit;
+}
+
+static uint32_t FindFirstSet(uint32_t value)
+{
+	uint32_t bit = 0;
+	while (!(value & 1)) {
+		value >>= 1;
+		bit++;
+	}
+	return bit;
+}
+
+// Sizes below SecondLevelCount get a bin each, larger ones are split into
+// SecondLevelCount linear bins per power of two
+static void MapSize(uint32_t size, uint32_t secondLevelBits, uint32_t* firstLevel, uint32_t* secondLevel)
+{
+	if (size < (1u << secondLevelBits)) {
+		*firstLevel = 0;
+		*secondLevel = size;
+	} else {
+		uint32_t log2 = FindLastSet(size);
+		*firstLevel = log2 - secondLevelBits + 1;
+		*secondLevel = (size >> (log2 - secondLevelBits)) & ((1u << secondLevelBits) - 1);
+	}
+}
+
+TlsfAllocator::TlsfAllocator(uint32_t size) :
+	mFirstLevelMask(0), mSize(size), mFreeSize(0), mFreeCount(0)
+{
+	std::fill(std::begin(mSecondLevelMasks), std::end(mSecondLevelMasks), 0);
+	std::fill(std::begin(mHeads), std::end(mHeads), Invalid);
+	if (size)
+		InsertFree(NewNode(0, size));
+}
+
+uint32_t TlsfAllocator::NewNode(uint32_t offset, uint32_t size)
+{
+	Node node = { offset, size, Invalid, Invalid, Invalid, Invalid, false };
+	if (!mUnusedNodes.empty()) {
+		uint32_t index = mUnusedNodes.back();
+		mUnusedNodes.pop_back();
+		mNodes[index] = node;
+		return index;
+	}
+	mNodes.push_back(node);
+	return static_cast<uint32_t>(mNodes.size() - 1);
+}
+
+void TlsfAllocator::InsertFree(uint32_t index)
+{
+	Node& node = mNodes[index];
+	uint32_t firstLevel, secondLevel;
+	MapSize(node.size, SecondLevelBits, &firstLevel, &secondLevel);
+	uint32_t& head = mHeads[firstLevel * SecondLevelCount + secondLevel];
+
+	node.used = false;
+	node.prevFree = Invalid;
+	node.nextFree = head;
+	if (head != Invalid)
+		mNodes[head].prevFree = index;
+	head = index;
+
+	mFirstLevelMask |= 1u << firstLevel;
+	mSecondLevelMasks[firstLevel] |= 1u << secondLevel;
+	mFreeSize += node.size;
+	mFreeCount++;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t index)
+{
+	Node& node = mNodes[index];
+	uint32_t firstLevel, secondLevel;
+	MapSize(node.size, SecondLevelBits, &firstLevel, &secondLevel);
+	uint32_t& head = mHeads[firstLevel * SecondLevelCount + secondLevel];
+
+	if (node.prevFree != Invalid)
+		mNodes[node.prevFree].nextFree = node.nextFree;
+	else
+		head = node.nextFree;
+	if (node.nextFree != Invalid)
+		mNodes[node.nextFree].prevFree = node.prevFree;
+
+	if (head == Invalid) {
+		mSecondLevelMasks[firstLevel] &= ~(1u << secondLevel);
+		if (!mSecondLevelMasks[firstLevel])
+			mFirstLevelMask &= ~(1u << firstLevel);
+	}
+	mFreeSize -= node.size;
+	mFreeCount--;
+}
+
+uint32_t TlsfAllocator::Allocate(uint32_t size, uint32_t* offset)
+{
+	if (size == 0 || size > mFreeSize)
+		return Invalid;
+
+	// Round up to the next bin so that every region of the bin found fits
+	uint32_t rounded = size;
+	if (size >= SecondLevelCount) {
+		uint32_t round = (1u << (FindLastSet(size) - SecondLevelBits)) - 1;
+		if (size > UINT32_MAX - round)
+			return Invalid;
+		rounded += round;
+	}
+
+	uint32_t firstLevel, secondLevel;
+	MapSize(rounded, SecondLevelBits, &firstLevel, &secondLevel);
+	uint32_t secondLevelMask = firstLevel < FirstLevelCount ? mSecondLevelMasks[firstLevel] & (~0u << secondLevel) : 0;
+	if (!secondLevelMask) {
+		uint32_t firstLevelMask = firstLevel + 1 < 32 ? mFirstLevelMask & (~0u << (firstLevel + 1)) : 0;
+		if (!firstLevelMask)
+			return Invalid;
+		firstLevel = FindFirstSet(firstLevelMask);
+		secondLevelMask = mSecondLevelMasks[firstLevel];
+	}
+	secondLevel = FindFirstSet(secondLevelMask);
+
+	uint32_t index = mHeads[firstLevel * SecondLevelCount + secondLevel];
+	RemoveFree(index);
+
+	// The remainder becomes a free region of its own
+	if (mNodes[index].size > size) {
+		uint32_t rest = NewNode(mNodes[index].offset + size, mNodes[index].size - size);
+		Node& node = mNodes[index];
+		mNodes[rest].prevPhysical = index;
+		mNodes[rest].nextPhysical = node.nextPhysical;
+		if (node.nextPhysical != Invalid)
+			mNodes[node.nextPhysical].prevPhysical = rest;
+		node.nextPhysical = rest;
+		node.size = size;
+		InsertFree(rest);
+	}
+
+	mNodes[index].used = true;
+	*offset = mNodes[index].offset;
+	return index;
+}
+
+void TlsfAllocator::Free(uint32_t handle)
+{
+	if (handle >= mNodes.size() || !mNodes[handle].used)
+		return;
+
+	uint32_t prev = mNodes[handle].prevPhysical;
+	if (prev != Invalid && !mNodes[prev].used) {
+		RemoveFree(prev);
+		mNodes[prev].size += mNodes[handle].size;
+		mNodes[prev].nextPhysical = mNodes[handle].nextPhysical;
+		if (mNodes[handle].nextPhysical != Invalid)
+			mNodes[mNodes[handle].nextPhysical].prevPhysical = prev;
+		mNodes[handle].used = false;
+		mUnusedNodes.push_back(handle);
+		handle = prev;
+	}
+
+	uint32_t next = mNodes[handle].nextPhysical;
+	if (next != Invalid && !mNodes[next].used) {
+		RemoveFree(next);
+		mNodes[handle].size += mNodes[next].size;
+		mNodes[handle].nextPhysical = mNodes[next].nextPhysical;
+		if (mNodes[next].nextPhysical != Invalid)
+			mNodes[mNodes[next].nextPhysical].prevPhysical = handle;
+		mUnusedNodes.push_back(next);
+	}
+
+	InsertFree(handle);
+}
+
+uint32_t TlsfAllocator::GetSize() const
+{
+	return mSize;
+}
+
+uint32_t TlsfAllocator::GetFreeSize() const
+{
+	return mFreeSize;
+}
+
+uint32_t TlsfAllocator::GetFreeRegionCount() const
+{
+	return mFreeCount;
+}
+
+// The largest region is in the highest non-empty bin, only that bin is searched
+uint32_t TlsfAllocator::GetLargestFreeRegion() const
+{
+	if (!mFirstLevelMask)
+		return 0;
+	uint32_t firstLevel = FindLastSet(mFirstLevelMask);
+	uint32_t secondLevel = FindLastSet(mSecondLevelMasks[firstLevel]);
+	uint32_t largest = 0;
+	for (uint32_t i = mHeads[firstLevel * SecondLevelCount + secondLevel]; i != Invalid; i = mNodes[i].nextFree)
+		largest = std::max(largest, mNodes[i].size);
+	return largest;
+}
+
+bool ArenaAllocation::IsValid() const
+{
+	return vertexHandle != TlsfAllocator::Invalid;
+}
+
+static const ArenaAllocation InvalidAllocation = { 0, 0, 0, 0, 0, 0, TlsfAllocator::Invalid, TlsfAllocator::Invalid };
+
+BufferArena::BufferArena(uint32_t vertexStride, DataType indexType, uint32_t verticesPerBlock, uint32_t indicesPerBlock, Flags<BufferStorageFlags> storageFlags) :
+	mVertexStride(vertexStride), mIndexType(indexType), mIndexSize(GetDataTypeSize(indexType)),
+	mVerticesPerBlock(verticesPerBlock), mIndicesPerBlock(indicesPerBlock), mAllocationCount(0), mStorageFlags(storageFlags)
+{}
+
+bool BufferArena::AllocateInBlock(uint32_t block, uint32_t vertexCount, uint32_t indexCount, ArenaAllocation* allocation)
+{
+	Block& b = mBlocks[block];
+	uint32_t firstVertex = 0;
+	uint32_t vertexHandle = b.vertexAllocator.Allocate(vertexCount, &firstVertex);
+	if (vertexHandle == TlsfAllocator::Invalid)
+		return false;
+
+	uint32_t firstIndex = 0;
+	uint32_t indexHandle = TlsfAllocator::Invalid;
+	if (indexCount) {
+		indexHandle = b.indexAllocator.Allocate(indexCount, &firstIndex);
+		if (indexHandle == TlsfAllocator::Invalid) {
+			b.vertexAllocator.Free(vertexHandle);
+			return false;
+		}
+	}
+
+	allocation->block = block;
+	allocation->baseVertex = static_cast<int32_t>(firstVertex);
+	allocation->vertexCount = vertexCount;
+	allocation->firstIndex = firstIndex;
+	allocation->indexCount = indexCount;
+	allocation->indexOffset = static_cast<intptr_t>(firstIndex) * mIndexSize;
+	allocation->vertexHandle = vertexHandle;
+	allocation->indexHandle = indexHandle;
+	return true;
+}
+
+ArenaAllocation BufferArena::Allocate(uint32_t vertexCount, uint32_t indexCount)
+{
+	ArenaAllocation allocation = InvalidAllocation;
+	if (vertexCount == 0)
+		return allocation;
+
+	for (uint32_t i = 0; i < mBlocks.size(); i++) {
+		if (AllocateInBlock(i, vertexCount, indexCount, &allocation)) {
+			mAllocationCount++;
+			return allocation;
+		}
+	}
+
+	uint32_t vertices = std::max(mVerticesPerBlock, vertexCount);
+	uint32_t indices = std::max(mIndicesPerBlock, indexCount);
+	Block block = {
+		Buffer(static_cast<intptr_t>(vertices) * mVertexStride, nullptr, mStorageFlags),
+		Buffer(static_cast<intptr_t>(indices) * mIndexSize, nullptr, mStorageFlags),
+		TlsfAllocator(vertices),
+		TlsfAllocator(indices)
+	};
+	if (!block.vertices || !block.indices)
+		return allocation;
+	mBlocks.push_back(std::move(block));
+
+	if (AllocateInBlock(static_cast<uint32_t>(mBlocks.size() - 1), vertexCount, indexCount, &allocation))
+		mAllocationCount++;
+	return allocation;
+}
+
+ArenaAllocation BufferArena::Allocate(uint32_t vertexCount, const void* vertices, uint32_t indexCount, const void* indices)
+{
+	ArenaAllocation allocation = Allocate(vertexCount, indexCount);
+	if (!allocation.IsValid())
+		return allocation;
+
+	Block& block = mBlocks[allocation.block];
+	if (vertices)
+		block.vertices.SubData(static_cast<intptr_t>(allocation.baseVertex) * mVertexStride, static_cast<intptr_t>(vertexCount) * mVertexStride, vertices);
+	if (indices && indexCount)
+		block.indices.SubData(allocation.indexOffset, static_cast<intptr_t>(indexCount) * mIndexSize, indices);
+	return allocation;
+}
+
+void BufferArena::Free(ArenaAllocation& allocation)
+{
+	if (!allocation.IsValid() || allocation.block >= mBlocks.size())
+		return;
+
+	Block& block = mBlocks[allocation.block];
+	block.vertexAllocator.Free(allocation.vertexHandle);
+	if (allocation.indexHandle != TlsfAllocator::Invalid)
+		block.indexAllocator.Free(allocation.indexHandle);
+	mAllocationCount--;
+	allocation = InvalidAllocation;
+}
+
+uint32_t BufferArena::GetBlockCount() const
+{
+	return static_cast<uint32_t>(mBlocks.size());
+}
+
+const Buffer& BufferArena::GetVertexBuffer(uint32_t block) const
+{
+	return mBlocks[block].vertices;
+}
+
+const Buffer& BufferArena::GetIndexBuffer(uint32_t block) const
+{
+	return mBlocks[block].indices;
+}
+
+uint32_t BufferArena::GetVertexStride() const
+{
+	return mVertexStride;
+}
+
+DataType BufferArena::GetIndexType() const
+{
+	return mIndexType;
+}
+
+BufferArenaStats BufferArena::GetStats() const
+{
+	BufferArenaStats stats = {};
+	stats.blockCount = static_cast<uint32_t>(mBlocks.size());
+	stats.allocationCount = mAllocationCount;
+
+	int64_t vertexFree = 0, indexFree = 0, vertexLargest = 0, indexLargest = 0;
+	for (const Block& block : mBlocks) {
+		stats.vertexBytes += static_cast<int64_t>(block.vertexAllocator.GetSize()) * mVertexStride;
+		stats.indexBytes += static_cast<int64_t>(block.indexAllocator.GetSize()) * mIndexSize;
+		vertexFree += static_cast<int64_t>(block.vertexAllocator.GetFreeSize()) * mVertexStride;
+		indexFree += static_cast<int64_t>(block.indexAllocator.GetFreeSize()) * mIndexSize;
+		vertexLargest = std::max<int64_t>(vertexLargest, static_cast<int64_t>(block.vertexAllocator.GetLargestFreeRegion()) * mVertexStride);
+		indexLargest = std::max<int64_t>(indexLargest, static_cast<int64_t>(block.indexAllocator.GetLargestFreeRegion()) * mIndexSize);
+		stats.freeRegionCount += block.vertexAllocator.GetFreeRegionCount() + block.indexAllocator.GetFreeRegionCount();
+	}
+	stats.vertexBytesUsed = stats.vertexBytes - vertexFree;
+	stats.indexBytesUsed = stats.indexBytes - indexFree;
+	stats.vertexFragmentation = vertexFree ? 1.0f - static_cast<float>(vertexLargest) / vertexFree : 0.0f;
+	stats.indexFragmentation = indexFree ? 1.0f - static_cast<float>(indexLargest) / indexFree : 0.0f;
+	return stats;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,549 @@
+#include <GLUtil/CommandList.h>
+#include <GLUtil/State.h>
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <cstring>
+
+#define RECORD(T, op, extra) static_cast<T*>(Record(static_cast<uint32_t>(CommandOp::op), sizeof(T) + (extra)))
+
+namespace GLUtil {
+
+enum class CommandOp : uint32_t
+{
+	BindBuffer,
+	BindBufferBase,
+	BindBufferRange,
+	BindTexture,
+	BindTextureUnit,
+	SetActiveTextureUnit,
+	BindSampler,
+	BindVertexArray,
+	UseProgram,
+	SetUniform,
+	EnableCapability,
+	DisableCapability,
+	ApplyPipelineState,
+	SetViewport,
+	SetScissorBox,
+	SetClearColor,
+	Clear,
+	DrawArrays,
+	DrawArraysIndirect,
+	MultiDrawArraysIndirect,
+	DrawElements,
+	DrawElementsIndirect,
+	MultiDrawElementsBaseVertex,
+	MultiDrawElementsIndirect
+};
+
+struct CommandHeader
+{
+	CommandOp op;
+	uint32_t size;
+};
+
+struct BindBufferCmd
+{
+	BufferTarget target;
+	uint32_t index;
+	uint32_t buffer;
+	intptr_t offset;
+	intptr_t size;
+};
+
+struct BindTextureCmd
+{
+	TextureTarget target;
+	uint32_t unit;
+	uint32_t texture;
+};
+
+struct UniformCmd
+{
+	uint32_t program;
+	int32_t location;
+	uint32_t index;
+	DataType type;
+};
+
+struct DrawCmd
+{
+	PrimitiveMode mode;
+	DataType type;
+	int32_t first;
+	int32_t count;
+	int32_t instanceCount;
+	int32_t baseVertex;
+	uint32_t baseInstance;
+	int32_t stride;
+	intptr_t offset;
+};
+
+static constexpr size_t CommandAlignment = 8;
+
+static size_t AlignCommand(size_t size)
+{
+	return (size + CommandAlignment - 1) & ~(CommandAlignment - 1);
+}
+
+CommandList::CommandList(size_t blockSize) :
+	mCurrentBlock(0), mBlockSize(blockSize), mCommandCount(0)
+{}
+
+void* CommandList::Record(uint32_t op, size_t size)
+{
+	size_t total = AlignCommand(sizeof(CommandHeader) + size);
+	while (mCurrentBlock < mBlocks.size() && mBlocks[mCurrentBlock].used + total > mBlocks[mCurrentBlock].size)
+		mCurrentBlock++;
+
+	if (mCurrentBlock == mBlocks.size()) {
+		Block block;
+		block.size = std::max(mBlockSize, total);
+		block.data.reset(new uint8_t[block.size]);
+		block.used = 0;
+		mBlocks.push_back(std::move(block));
+	}
+
+	Block& block = mBlocks[mCurrentBlock];
+	CommandHeader* header = reinterpret_cast<CommandHeader*>(block.data.get() + block.used);
+	header->op = static_cast<CommandOp>(op);
+	header->size = static_cast<uint32_t>(total);
+	block.used += total;
+	mCommandCount++;
+	return header + 1;
+}
+
+void CommandList::Reset()
+{
+	for (Block& block : mBlocks)
+		block.used = 0;
+	mCurrentBlock = 0;
+	mCommandCount = 0;
+}
+
+static void ExecuteUniform(const UniformCmd* cmd)
+{
+	ProgramUniform uniform(cmd->program, cmd->location, cmd->index);
+	const void* data = cmd + 1;
+	const float* f = static_cast<const float*>(data);
+	const int32_t* i = static_cast<const int32_t*>(data);
+	const uint32_t* u = static_cast<const uint32_t*>(data);
+	switch (cmd->type) {
+		case DataType::Float:
+			uniform.Set(*f);
+			break;
+		case DataType::FloatVec2:
+			uniform.SetFloat2V(f);
+			break;
+		case DataType::FloatVec3:
+			uniform.SetFloat3V(f);
+			break;
+		case DataType::FloatVec4:
+			uniform.SetFloat4V(f);
+			break;
+		case DataType::FloatMat2:
+			uniform.SetFloat2x2V(f);
+			break;
+		case DataType::FloatMat3:
+			uniform.SetFloat3x3V(f);
+			break;
+		case DataType::FloatMat4:
+			uniform.SetFloat4x4V(f);
+			break;
+		case DataType::Int:
+			uniform.Set(*i);
+			break;
+		case DataType::IntVec2:
+			uniform.SetInt2V(i);
+			break;
+		case DataType::IntVec3:
+			uniform.SetInt3V(i);
+			break;
+		case DataType::IntVec4:
+			uniform.SetInt4V(i);
+			break;
+		case DataType::UnsignedInt:
+			uniform.Set(*u);
+			break;
+		case DataType::UnsignedIntVec2:
+			uniform.SetUnsignedInt2V(u);
+			break;
+		case DataType::UnsignedIntVec3:
+			uniform.SetUnsignedInt3V(u);
+			break;
+		case DataType::UnsignedIntVec4:
+			uniform.SetUnsignedInt4V(u);
+			break;
+		default:
+			break;
+	}
+}
+
+static void ExecuteCommand(CommandOp op, const void* data)
+{
+	const BindBufferCmd* buffer = static_cast<const BindBufferCmd*>(data);
+	const BindTextureCmd* texture = static_cast<const BindTextureCmd*>(data);
+	const DrawCmd* draw = static_cast<const DrawCmd*>(data);
+	const uint32_t* value = static_cast<const uint32_t*>(data);
+
+	switch (op) {
+		case CommandOp::BindBuffer:
+			GLUtil::BindBuffer(buffer->target, buffer->buffer);
+			break;
+		case CommandOp::BindBufferBase:
+			GLUtil::BindBufferBase(buffer->target, buffer->index, buffer->buffer);
+			break;
+		case CommandOp::BindBufferRange:
+			GLUtil::BindBufferRange(buffer->target, buffer->index, buffer->buffer, buffer->offset, buffer->size);
+			break;
+		case CommandOp::BindTexture:
+			GLUtil::BindTexture(texture->target, texture->texture);
+			break;
+		case CommandOp::BindTextureUnit:
+			GLUtil::BindTextureUnit(texture->unit, texture->texture);
+			break;
+		case CommandOp::SetActiveTextureUnit:
+			GLUtil::SetActiveTextureUnit(*value);
+			break;
+		case CommandOp::BindSampler:
+			GLUtil::BindSampler(value[0], value[1]);
+			break;
+		case CommandOp::BindVertexArray:
+			GLUtil::BindVertexArray(*value);
+			break;
+		case CommandOp::UseProgram: {
+			GLUTIL_GL_CALL(glUseProgram(*value));
+			break;
+		}
+		case CommandOp::SetUniform:
+			ExecuteUniform(static_cast<const UniformCmd*>(data));
+			break;
+		case CommandOp::EnableCapability:
+			GLUtil::EnableCapability(static_cast<Capability>(*value));
+			break;
+		case CommandOp::DisableCapability:
+			GLUtil::DisableCapability(static_cast<Capability>(*value));
+			break;
+		case CommandOp::ApplyPipelineState:
+			static_cast<const PipelineState*>(data)->Apply();
+			break;
+		case CommandOp::SetViewport:
+			GLUtil::SetViewport(*static_cast<const Box*>(data));
+			break;
+		case CommandOp::SetScissorBox:
+			GLUtil::SetScissorBox(*static_cast<const Box*>(data));
+			break;
+		case CommandOp::SetClearColor:
+			GLUtil::SetClearColor(*static_cast<const Vec4f*>(data));
+			break;
+		case CommandOp::Clear:
+			GLUtil::Clear(*value);
+			break;
+		case CommandOp::DrawArrays:
+			GLUtil::DrawArraysInstanced(draw->mode, draw->first, draw->count, draw->instanceCount, draw->baseInstance);
+			break;
+		case CommandOp::DrawArraysIndirect:
+			GLUtil::DrawArraysIndirect(draw->mode, draw->offset);
+			break;
+		case CommandOp::MultiDrawArraysIndirect:
+			GLUtil::MultiDrawArraysIndirect(draw->mode, draw->offset, draw->count, draw->stride);
+			break;
+		case CommandOp::DrawElements:
+			GLUtil::DrawElementsInstanced(draw->mode, draw->count, draw->type, draw->offset, draw->instanceCount, draw->baseVertex, draw->baseInstance);
+			break;
+		case CommandOp::DrawElementsIndirect:
+			GLUtil::DrawElementsIndirect(draw->mode, draw->type, draw->offset);
+			break;
+		case CommandOp::MultiDrawElementsBaseVertex: {
+			const int32_t* counts = reinterpret_cast<const int32_t*>(draw + 1);
+			const intptr_t* offsets = reinterpret_cast<const intptr_t*>(counts + AlignCommand(draw->count * sizeof(int32_t)) / sizeof(int32_t));
+			const int32_t* baseVertices = reinterpret_cast<const int32_t*>(offsets + draw->count);
+			GLUtil::MultiDrawElementsBaseVertex(draw->mode, counts, draw->type, offsets, draw->count, baseVertices);
+			break;
+		}
+		case CommandOp::MultiDrawElementsIndirect:
+			GLUtil::MultiDrawElementsIndirect(draw->mode, draw->type, draw->offset, draw->count, draw->stride);
+			break;
+	}
+}
+
+void CommandList::Execute() const
+{
+	for (const Block& block : mBlocks) {
+		size_t offset = 0;
+		while (offset < block.used) {
+			const CommandHeader* header = reinterpret_cast<const CommandHeader*>(block.data.get() + offset);
+			ExecuteCommand(header->op, header + 1);
+			offset += header->size;
+		}
+	}
+}
+
+CommandList& CommandList::BindBuffer(BufferTarget target, uint32_t buffer)
+{
+	*RECORD(BindBufferCmd, BindBuffer, 0) = { target, 0, buffer, 0, 0 };
+	return *this;
+}
+
+CommandList& CommandList::BindBufferBase(BufferTarget target, uint32_t index, uint32_t buffer)
+{
+	*RECORD(BindBufferCmd, BindBufferBase, 0) = { target, index, buffer, 0, 0 };
+	return *this;
+}
+
+CommandList& CommandList::BindBufferRange(BufferTarget target, uint32_t index, uint32_t buffer, intptr_t offset, intptr_t size)
+{
+	*RECORD(BindBufferCmd, BindBufferRange, 0) = { target, index, buffer, offset, size };
+	return *this;
+}
+
+CommandList& CommandList::BindTexture(TextureTarget target, uint32_t texture)
+{
+	*RECORD(BindTextureCmd, BindTexture, 0) = { target, 0, texture };
+	return *this;
+}
+
+CommandList& CommandList::BindTextureUnit(uint32_t unit, uint32_t texture)
+{
+	*RECORD(BindTextureCmd, BindTextureUnit, 0) = { static_cast<TextureTarget>(0), unit, texture };
+	return *this;
+}
+
+CommandList& CommandList::SetActiveTextureUnit(uint32_t unit)
+{
+	*RECORD(uint32_t, SetActiveTextureUnit, 0) = unit;
+	return *this;
+}
+
+CommandList& CommandList::BindSampler(uint32_t unit, uint32_t sampler)
+{
+	uint32_t* cmd = RECORD(uint32_t, BindSampler, sizeof(uint32_t));
+	cmd[0] = unit;
+	cmd[1] = sampler;
+	return *this;
+}
+
+CommandList& CommandList::BindVertexArray(uint32_t vertexArray)
+{
+	*RECORD(uint32_t, BindVertexArray, 0) = vertexArray;
+	return *this;
+}
+
+CommandList& CommandList::UseProgram(uint32_t program)
+{
+	*RECORD(uint32_t, UseProgram, 0) = program;
+	return *this;
+}
+
+template<typename T>
+CommandList& CommandList::RecordUniform(const ProgramUniform& uniform, DataType type, const T& value)
+{
+	UniformCmd* cmd = RECORD(UniformCmd, SetUniform, sizeof(T));
+	*cmd = { uniform.GetProgram(), uniform.GetLocation(), uniform.GetIndex(), type };
+	memcpy(cmd + 1, &value, sizeof(T));
+	return *this;
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, float v)
+{
+	return RecordUniform(uniform, DataType::Float, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec2f& v)
+{
+	return RecordUniform(uniform, DataType::FloatVec2, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec3f& v)
+{
+	return RecordUniform(uniform, DataType::FloatVec3, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec4f& v)
+{
+	return RecordUniform(uniform, DataType::FloatVec4, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Mat2f& v)
+{
+	return RecordUniform(uniform, DataType::FloatMat2, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Mat3f& v)
+{
+	return RecordUniform(uniform, DataType::FloatMat3, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Mat4f& v)
+{
+	return RecordUniform(uniform, DataType::FloatMat4, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, int32_t v)
+{
+	return RecordUniform(uniform, DataType::Int, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec2i& v)
+{
+	return RecordUniform(uniform, DataType::IntVec2, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec3i& v)
+{
+	return RecordUniform(uniform, DataType::IntVec3, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec4i& v)
+{
+	return RecordUniform(uniform, DataType::IntVec4, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, uint32_t v)
+{
+	return RecordUniform(uniform, DataType::UnsignedInt, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec2ui& v)
+{
+	return RecordUniform(uniform, DataType::UnsignedIntVec2, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec3ui& v)
+{
+	return RecordUniform(uniform, DataType::UnsignedIntVec3, v);
+}
+
+CommandList& CommandList::SetUniform(const ProgramUniform& uniform, const Vec4ui& v)
+{
+	return RecordUniform(uniform, DataType::UnsignedIntVec4, v);
+}
+
+CommandList& CommandList::EnableCapability(Capability cap)
+{
+	*RECORD(uint32_t, EnableCapability, 0) = static_cast<uint32_t>(cap);
+	return *this;
+}
+
+CommandList& CommandList::DisableCapability(Capability cap)
+{
+	*RECORD(uint32_t, DisableCapability, 0) = static_cast<uint32_t>(cap);
+	return *this;
+}
+
+CommandList& CommandList::ApplyPipelineState(const PipelineState& state)
+{
+	memcpy(RECORD(PipelineState, ApplyPipelineState, 0), &state, sizeof(PipelineState));
+	return *this;
+}
+
+CommandList& CommandList::SetViewport(Box box)
+{
+	*RECORD(Box, SetViewport, 0) = box;
+	return *this;
+}
+
+CommandList& CommandList::SetScissorBox(Box box)
+{
+	*RECORD(Box, SetScissorBox, 0) = box;
+	return *this;
+}
+
+CommandList& CommandList::SetClearColor(Vec4f color)
+{
+	*RECORD(Vec4f, SetClearColor, 0) = color;
+	return *this;
+}
+
+CommandList& CommandList::Clear(Flags<ClearMask> mask)
+{
+	*RECORD(uint32_t, Clear, 0) = mask;
+	return *this;
+}
+
+CommandList& CommandList::DrawArrays(PrimitiveMode mode, int32_t first, int32_t count)
+{
+	return DrawArraysInstanced(mode, first, count, 1, 0);
+}
+
+CommandList& CommandList::DrawArraysInstanced(PrimitiveMode mode, int32_t first, int32_t count, int32_t instanceCount, uint32_t baseInstance)
+{
+	*RECORD(DrawCmd, DrawArrays, 0) = { mode, static_cast<DataType>(0), first, count, instanceCount, 0, baseInstance, 0, 0 };
+	return *this;
+}
+
+CommandList& CommandList::DrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset)
+{
+	*RECORD(DrawCmd, DrawArraysIndirect, 0) = { mode, static_cast<DataType>(0), 0, 0, 0, 0, 0, 0, indirectOffset };
+	return *this;
+}
+
+CommandList& CommandList::MultiDrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset, int32_t drawCount, int32_t stride)
+{
+	*RECORD(DrawCmd, MultiDrawArraysIndirect, 0) = { mode, static_cast<DataType>(0), 0, drawCount, 0, 0, 0, stride, indirectOffset };
+	return *this;
+}
+
+CommandList& CommandList::DrawElements(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset)
+{
+	return DrawElementsInstanced(mode, count, type, indexOffset, 1, 0, 0);
+}
+
+CommandList& CommandList::DrawElementsBaseVertex(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t baseVertex)
+{
+	return DrawElementsInstanced(mode, count, type, indexOffset, 1, baseVertex, 0);
+}
+
+CommandList& CommandList::DrawElementsInstanced(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t instanceCount, int32_t baseVertex, uint32_t baseInstance)
+{
+	*RECORD(DrawCmd, DrawElements, 0) = { mode, type, 0, count, instanceCount, baseVertex, baseInstance, 0, indexOffset };
+	return *this;
+}
+
+CommandList& CommandList::DrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset)
+{
+	*RECORD(DrawCmd, DrawElementsIndirect, 0) = { mode, type, 0, 0, 0, 0, 0, 0, indirectOffset };
+	return *this;
+}
+
+// The arrays are copied into the list: counts, padding, index offsets, base vertices
+CommandList& CommandList::MultiDrawElementsBaseVertex(PrimitiveMode mode, const int32_t* counts, DataType type, const intptr_t* indexOffsets, int32_t drawCount, const int32_t* baseVertices)
+{
+	size_t countsSize = AlignCommand(drawCount * sizeof(int32_t));
+	size_t offsetsSize = drawCount * sizeof(intptr_t);
+	DrawCmd* cmd = RECORD(DrawCmd, MultiDrawElementsBaseVertex, countsSize + offsetsSize + drawCount * sizeof(int32_t));
+	*cmd = { mode, type, 0, drawCount, 0, 0, 0, 0, 0 };
+	uint8_t* data = reinterpret_cast<uint8_t*>(cmd + 1);
+	memcpy(data, counts, drawCount * sizeof(int32_t));
+	memcpy(data + countsSize, indexOffsets, offsetsSize);
+	memcpy(data + countsSize + offsetsSize, baseVertices, drawCount * sizeof(int32_t));
+	return *this;
+}
+
+CommandList& CommandList::MultiDrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset, int32_t drawCount, int32_t stride)
+{
+	*RECORD(DrawCmd, MultiDrawElementsIndirect, 0) = { mode, type, 0, drawCount, 0, 0, 0, stride, indirectOffset };
+	return *this;
+}
+
+bool CommandList::IsEmpty() const
+{
+	return mCommandCount == 0;
+}
+
+uint32_t CommandList::GetCommandCount() const
+{
+	return mCommandCount;
+}
+
+size_t CommandList::GetSize() const
+{
+	size_t size = 0;
+	for (const Block& block : mBlocks)
+		size += block.used;
+	return size;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <GLUtil/Common.h>
+
+namespace GLUtil {
+
+// Client side size of one element, samplers are set as int
+uint32_t GetDataTypeSize(DataType type)
+{
+	switch (type) {
+		case DataType::Byte:
+		case DataType::UnsignedByte:
+			return 1;
+		case DataType::Short:
+		case DataType::UnsignedShort:
+			return 2;
+		case DataType::Float:
+		case DataType::Int:
+		case DataType::UnsignedInt:
+		case DataType::Bool:
+			return 4;
+		case DataType::FloatVec2:
+		case DataType::IntVec2:
+		case DataType::UnsignedIntVec2:
+		case DataType::BoolVec2:
+		case DataType::Double:
+			return 8;
+		case DataType::FloatVec3:
+		case DataType::IntVec3:
+		case DataType::UnsignedIntVec3:
+		case DataType::BoolVec3:
+			return 12;
+		case DataType::FloatVec4:
+		case DataType::IntVec4:
+		case DataType::UnsignedIntVec4:
+		case DataType::BoolVec4:
+		case DataType::DoubleVec2:
+		case DataType::FloatMat2:
+			return 16;
+		case DataType::DoubleVec3:
+		case DataType::FloatMat2x3:
+		case DataType::FloatMat3x2:
+			return 24;
+		case DataType::DoubleVec4:
+		case DataType::FloatMat2x4:
+		case DataType::FloatMat4x2:
+		case DataType::DoubleMat2:
+			return 32;
+		case DataType::FloatMat3:
+			return 36;
+		case DataType::FloatMat3x4:
+		case DataType::FloatMat4x3:
+		case DataType::DoubleMat2x3:
+		case DataType::DoubleMat3x2:
+			return 48;
+		case DataType::FloatMat4:
+		case DataType::DoubleMat2x4:
+		case DataType::DoubleMat4x2:
+			return 64;
+		case DataType::DoubleMat3:
+			return 72;
+		case DataType::DoubleMat3x4:
+		case DataType::DoubleMat4x3:
+			return 96;
+		case DataType::DoubleMat4:
+			return 128;
+		case DataType::Sampler1D:
+		case DataType::Sampler2D:
+		case DataType::Sampler3D:
+		case DataType::SamplerCube:
+		case DataType::Sampler1DShadow:
+		case DataType::Sampler2DShadow:
+		case DataType::Sampler1DArray:
+		case DataType::Sampler2DArray:
+		case DataType::Sampler1DArrayShadow:
+		case DataType::Sampler2DArrayShadow:
+		case DataType::Sampler2DMultisample:
+		case DataType::Sampler2DMultisampleArray:
+		case DataType::SamplerCubeShadow:
+		case DataType::SamplerBuffer:
+		case DataType::Sampler2DRect:
+		case DataType::Sampler2DRectShadow:
+		case DataType::IntSampler1D:
+		case DataType::IntSampler2D:
+		case DataType::IntSampler3D:
+		case DataType::IntSamplerCube:
+		case DataType::IntSampler1DArray:
+		case DataType::IntSampler2DArray:
+		case DataType::IntSampler2DMultisample:
+		case DataType::IntSampler2DMultisampleArray:
+		case DataType::IntSamplerBuffer:
+		case DataType::IntSampler2DRect:
+		case DataType::UnsignedIntSampler1D:
+		case DataType::UnsignedIntSampler2D:
+		case DataType::UnsignedIntSampler3D:
+		case DataType::UnsignedIntSamplerCube:
+		case DataType::UnsignedIntSampler1DArray:
+		case DataType::UnsignedIntSampler2DArray:
+		case DataType::UnsignedIntSampler2DMultisample:
+		case DataType::UnsignedIntSampler2DMultisampleArray:
+		case DataType::UnsignedIntSamplerBuffer:
+		case DataType::UnsignedIntSampler2DRect:
+			return 4;
+	}
+	return 0;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -33,4 +33,14 @@ const char* GetErrorString(Error error)
 	}
 }
 
+void PushDebugGroup(const char* message, uint32_t id)
+{
+	GLUTIL_GL_CALL(glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, id, -1, message));
+}
+
+void PopDebugGroup()
+{
+	GLUTIL_GL_CALL(glPopDebugGroup());
+}
+
 } // namespace GLUtil
\ No newline at end of file
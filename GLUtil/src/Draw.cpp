@@ -0,0 +1,75 @@
+#include <GLUtil/Draw.h>
+#include <GLUtil/StateCache.h>
+
+#include <glad/gl.h>
+
+#define ENUM(e) static_cast<GLenum>(e)
+#define OFFSET(o) reinterpret_cast<const void*>(o)
+
+namespace GLUtil {
+
+void Clear(Flags<ClearMask> mask)
+{
+	GLUTIL_GL_CALL(glClear(mask));
+}
+
+void BindVertexArray(uint32_t vertexArray)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		if (CachedValue<uint32_t>* cached = cache->GetBufferBinding(BufferTarget::ElementArray))
+			cached->Invalidate();
+	}
+	GLUTIL_GL_CALL(glBindVertexArray(vertexArray));
+}
+
+void DrawArrays(PrimitiveMode mode, int32_t first, int32_t count)
+{
+	GLUTIL_GL_CALL(glDrawArrays(ENUM(mode), first, count));
+}
+
+void DrawArraysInstanced(PrimitiveMode mode, int32_t first, int32_t count, int32_t instanceCount, uint32_t baseInstance)
+{
+	GLUTIL_GL_CALL(glDrawArraysInstancedBaseInstance(ENUM(mode), first, count, instanceCount, baseInstance));
+}
+
+void DrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset)
+{
+	GLUTIL_GL_CALL(glDrawArraysIndirect(ENUM(mode), OFFSET(indirectOffset)));
+}
+
+void MultiDrawArraysIndirect(PrimitiveMode mode, intptr_t indirectOffset, int32_t drawCount, int32_t stride)
+{
+	GLUTIL_GL_CALL(glMultiDrawArraysIndirect(ENUM(mode), OFFSET(indirectOffset), drawCount, stride));
+}
+
+void DrawElements(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset)
+{
+	GLUTIL_GL_CALL(glDrawElements(ENUM(mode), count, ENUM(type), OFFSET(indexOffset)));
+}
+
+void DrawElementsBaseVertex(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t baseVertex)
+{
+	GLUTIL_GL_CALL(glDrawElementsBaseVertex(ENUM(mode), count, ENUM(type), OFFSET(indexOffset), baseVertex));
+}
+
+void DrawElementsInstanced(PrimitiveMode mode, int32_t count, DataType type, intptr_t indexOffset, int32_t instanceCount, int32_t baseVertex, uint32_t baseInstance)
+{
+	GLUTIL_GL_CALL(glDrawElementsInstancedBaseVertexBaseInstance(ENUM(mode), count, ENUM(type), OFFSET(indexOffset), instanceCount, baseVertex, baseInstance));
+}
+
+void DrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset)
+{
+	GLUTIL_GL_CALL(glDrawElementsIndirect(ENUM(mode), ENUM(type), OFFSET(indirectOffset)));
+}
+
+void MultiDrawElementsBaseVertex(PrimitiveMode mode, const int32_t* counts, DataType type, const intptr_t* indexOffsets, int32_t drawCount, const int32_t* baseVertices)
+{
+	GLUTIL_GL_CALL(glMultiDrawElementsBaseVertex(ENUM(mode), counts, ENUM(type), reinterpret_cast<const void* const*>(indexOffsets), drawCount, baseVertices));
+}
+
+void MultiDrawElementsIndirect(PrimitiveMode mode, DataType type, intptr_t indirectOffset, int32_t drawCount, int32_t stride)
+{
+	GLUTIL_GL_CALL(glMultiDrawElementsIndirect(ENUM(mode), ENUM(type), OFFSET(indirectOffset), drawCount, stride));
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <GLUtil/GLCall.h>
+#include <GLUtil/Debug.h>
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace GLUtil {
+
+static void DefaultGLErrorHandler(uint32_t error, const char* call, const char* file, int line)
+{
+	fprintf(stderr, "%s(%d): %s (0x%04X) in %s\n", file, line, GetErrorString(static_cast<Error>(error)), error, call);
+}
+
+static std::atomic<GLErrorHandler> sErrorHandler(DefaultGLErrorHandler);
+
+void SetGLErrorHandler(GLErrorHandler handler)
+{
+	sErrorHandler.store(handler ? handler : DefaultGLErrorHandler);
+}
+
+namespace Detail {
+
+// Sites and entry points live until exit, the probes hold raw pointers to them
+struct GLCallRegistry
+{
+	std::mutex mutex;
+	std::deque<std::string> names;
+	std::deque<GLEntryPoint> entryPoints;
+	std::deque<GLCallSite> sites;
+	std::unordered_map<std::string, GLEntryPoint*> entryPointMap;
+};
+
+static GLCallRegistry& GetRegistry()
+{
+	static GLCallRegistry registry;
+	return registry;
+}
+
+// The first glXxx identifier of the call text, calls may assign the result or cast it
+static std::string GetEntryPointName(const char* call)
+{
+	auto isIdent = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; };
+	for (const char* p = call; *p; p++) {
+		if (p[0] == 'g' && p[1] == 'l' && p[2] >= 'A' && p[2] <= 'Z' && (p == call || !isIdent(p[-1]))) {
+			const char* end = p;
+			while (isIdent(*end))
+				end++;
+			return std::string(p, end);
+		}
+	}
+	return call;
+}
+
+const GLCallSite* RegisterGLCallSite(const char* call, const char* file, int line)
+{
+	GLCallRegistry& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	std::string name = GetEntryPointName(call);
+	GLEntryPoint*& entry = registry.entryPointMap[name];
+	if (!entry) {
+		registry.names.push_back(name);
+		registry.entryPoints.emplace_back();
+		entry = &registry.entryPoints.back();
+		entry->name = registry.names.back().c_str();
+		entry->calls = 0;
+		entry->ticks = 0;
+	}
+
+	registry.sites.push_back({ entry, call, file, line });
+	return &registry.sites.back();
+}
+
+void CheckGLError(const GLCallSite* site)
+{
+	for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError())
+		sErrorHandler.load()(error, site->call, site->file, site->line);
+}
+
+} // namespace Detail
+
+#if GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TIME
+static const uint64_t sStartTicks = Detail::ReadTicks();
+static const std::chrono::steady_clock::time_point sStartTime = std::chrono::steady_clock::now();
+
+// Calibrates the TSC against the steady clock over the whole run so far
+static double GetMillisecondsPerTick()
+{
+	uint64_t ticks = Detail::ReadTicks() - sStartTicks;
+	double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sStartTime).count();
+	return ticks ? elapsed / ticks : 0.0;
+}
+#elif GLUTIL_GL_CALL_MODE == GLUTIL_GL_CALL_TRACE
+static double GetMillisecondsPerTick()
+{
+	return 1e-6;
+}
+#else
+static double GetMillisecondsPerTick()
+{
+	return 0.0;
+}
+#endif
+
+std::vector<GLCallStats> GetGLCallStats(GLCallSort sort, uint32_t count)
+{
+	Detail::GLCallRegistry& registry = Detail::GetRegistry();
+	double msPerTick = GetMillisecondsPerTick();
+
+	std::vector<GLCallStats> stats;
+	{
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		stats.reserve(registry.entryPoints.size());
+		for (const Detail::GLEntryPoint& entry : registry.entryPoints) {
+			uint64_t calls = entry.calls.load(std::memory_order_relaxed);
+			if (calls)
+				stats.push_back({ entry.name, calls, entry.ticks.load(std::memory_order_relaxed) * msPerTick });
+		}
+	}
+
+	std::sort(stats.begin(), stats.end(), [sort](const GLCallStats& a, const GLCallStats& b) {
+		if (sort == GLCallSort::Time && a.milliseconds != b.milliseconds)
+			return a.milliseconds > b.milliseconds;
+		return a.calls > b.calls;
+	});
+	if (count && stats.size() > count)
+		stats.resize(count);
+	return stats;
+}
+
+void DumpGLCallStats(std::FILE* file, GLCallSort sort, uint32_t count)
+{
+	std::vector<GLCallStats> stats = GetGLCallStats(sort, count);
+	fprintf(file, "%-40s %12s %12s %12s\n", "entry point", "calls", "total ms", "avg us");
+	for (const GLCallStats& entry : stats)
+		fprintf(file, "%-40s %12llu %12.3f %12.3f\n", entry.name, static_cast<unsigned long long>(entry.calls), entry.milliseconds, entry.milliseconds * 1000.0 / entry.calls);
+}
+
+void ResetGLCallStats()
+{
+	Detail::GLCallRegistry& registry = Detail::GetRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (Detail::GLEntryPoint& entry : registry.entryPoints) {
+		entry.calls.store(0, std::memory_order_relaxed);
+		entry.ticks.store(0, std::memory_order_relaxed);
+	}
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include <GLUtil/GpuProfiler.h>
+#include <GLUtil/Debug.h>
+#include <GLUtil/Hash.h>
+#include <GLUtil/Trace.h>
+
+#include <glad/gl.h>
+
+#include <algorithm>
+
+namespace GLUtil {
+
+static constexpr uint32_t NoRecord = 0xFFFFFFFF;
+
+GpuProfiler::GpuProfiler(uint32_t latency, uint32_t historySize) :
+	mFrames(std::max(latency, 1u)), mFrameIndex(0), mHistorySize(std::max(historySize, 1u)),
+	mDroppedFrames(0), mDebugGroups(GLAD_GL_VERSION_4_3 || GLAD_GL_KHR_debug), mInFrame(false)
+{
+	for (Frame& frame : mFrames) {
+		frame.queryCount = 0;
+		frame.pending = false;
+	}
+}
+
+uint32_t GpuProfiler::Timestamp(Frame& frame)
+{
+	if (frame.queryCount == frame.queries.size())
+		frame.queries.push_back(Query::Create(QueryTarget::Timestamp));
+	frame.queries[frame.queryCount].Timestamp();
+	return frame.queryCount++;
+}
+
+uint32_t GpuProfiler::GetScopeIndex(const char* name)
+{
+	auto it = mScopeIndices.find(HashString(name));
+	if (it != mScopeIndices.end())
+		return it->second;
+
+	GpuScopeStats stats;
+	stats.name = name;
+	stats.depth = 0;
+	stats.last = stats.min = stats.avg = stats.max = 0.0;
+	stats.history.reserve(mHistorySize);
+	stats.historyNext = 0;
+	mScopes.push_back(std::move(stats));
+	mFrameTimes.push_back(-1.0);
+
+	uint32_t index = static_cast<uint32_t>(mScopes.size() - 1);
+	mScopeIndices.emplace(HashString(name), index);
+	return index;
+}
+
+void GpuProfiler::AddSample(GpuScopeStats& stats, double time)
+{
+	if (stats.history.size() < mHistorySize)
+		stats.history.push_back(time);
+	else
+		stats.history[stats.historyNext] = time;
+	stats.historyNext = (stats.historyNext + 1) % mHistorySize;
+
+	stats.last = time;
+	stats.min = stats.max = time;
+	double sum = 0.0;
+	for (double sample : stats.history) {
+		stats.min = std::min(stats.min, sample);
+		stats.max = std::max(stats.max, sample);
+		sum += sample;
+	}
+	stats.avg = sum / stats.history.size();
+}
+
+// The timestamps complete in order, the last one being available means all are
+void GpuProfiler::Resolve(Frame& frame)
+{
+	frame.pending = false;
+	if (frame.queryCount == 0)
+		return;
+	if (!frame.queries[frame.queryCount - 1].IsResultAvailable()) {
+		mDroppedFrames++;
+		return;
+	}
+
+	bool trace = TraceRecorder::IsCapturing();
+	for (const Record& record : frame.records) {
+		if (record.end == NoRecord)
+			continue;
+		uint64_t begin = frame.queries[record.begin].GetResult();
+		uint64_t end = frame.queries[record.end].GetResult();
+		if (trace)
+			TraceRecorder::RecordGpu(mScopes[record.scope].name.c_str(), begin, end, record.depth);
+		double& time = mFrameTimes[record.scope];
+		time = std::max(time, 0.0) + (end > begin ? end - begin : 0) * 1e-6;
+		mScopes[record.scope].depth = record.depth;
+	}
+
+	for (const Record& record : frame.records) {
+		double& time = mFrameTimes[record.scope];
+		if (time >= 0.0) {
+			AddSample(mScopes[record.scope], time);
+			time = -1.0;
+		}
+	}
+}
+
+void GpuProfiler::BeginFrame()
+{
+	if (mInFrame)
+		EndFrame();
+
+	Frame& frame = mFrames[mFrameIndex];
+	if (frame.pending)
+		Resolve(frame);
+	frame.queryCount = 0;
+	frame.records.clear();
+
+	if (TraceRecorder::IsCapturing() && !TraceRecorder::IsGpuClockSynced())
+		TraceRecorder::SyncGpuClock(GetTimestamp());
+
+	mInFrame = true;
+	BeginScope("Frame");
+}
+
+void GpuProfiler::EndFrame()
+{
+	if (!mInFrame)
+		return;
+	while (!mStack.empty())
+		EndScope();
+
+	mFrames[mFrameIndex].pending = true;
+	mFrameIndex = (mFrameIndex + 1) % mFrames.size();
+	mInFrame = false;
+}
+
+void GpuProfiler::BeginScope(const char* name)
+{
+	if (mDebugGroups)
+		PushDebugGroup(name);
+
+	if (!mInFrame) {
+		mStack.push_back(NoRecord);
+		return;
+	}
+
+	Frame& frame = mFrames[mFrameIndex];
+	Record record;
+	record.scope = GetScopeIndex(name);
+	record.depth = static_cast<uint32_t>(mStack.size());
+	record.begin = Timestamp(frame);
+	record.end = NoRecord;
+	mStack.push_back(static_cast<uint32_t>(frame.records.size()));
+	frame.records.push_back(record);
+}
+
+void GpuProfiler::EndScope()
+{
+	if (mStack.empty())
+		return;
+
+	uint32_t index = mStack.back();
+	mStack.pop_back();
+	if (index != NoRecord && mInFrame) {
+		Frame& frame = mFrames[mFrameIndex];
+		frame.records[index].end = Timestamp(frame);
+	}
+
+	if (mDebugGroups)
+		PopDebugGroup();
+}
+
+GpuProfiler& GpuProfiler::SetDebugGroups(bool enable)
+{
+	mDebugGroups = enable;
+	return *this;
+}
+
+const GpuScopeStats* GpuProfiler::GetStats(const char* name) const
+{
+	auto it = mScopeIndices.find(HashString(name));
+	return it != mScopeIndices.end() ? &mScopes[it->second] : nullptr;
+}
+
+const std::vector<GpuScopeStats>& GpuProfiler::GetScopes() const
+{
+	return mScopes;
+}
+
+uint64_t GpuProfiler::GetDroppedFrames() const
+{
+	return mDroppedFrames;
+}
+
+void GpuProfiler::ResetStats()
+{
+	for (GpuScopeStats& stats : mScopes) {
+		stats.last = stats.min = stats.avg = stats.max = 0.0;
+		stats.history.clear();
+		stats.historyNext = 0;
+	}
+	mDroppedFrames = 0;
+}
+
+GpuScope::GpuScope(GpuProfiler& profiler, const char* name) :
+	mProfiler(profiler)
+{
+	mProfiler.BeginScope(name);
+}
+
+GpuScope::~GpuScope()
+{
+	mProfiler.EndScope();
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include <GLUtil/PipelineState.h>
+#include <GLUtil/Hash.h>
+
+#include <cstring>
+
+namespace GLUtil {
+
+static thread_local PipelineStateDesc sApplied;
+static thread_local bool sAppliedValid = false;
+
+static const StencilFuncState sDefaultStencilFunc = { CompareFunc::Always, 0, 0xFFFFFFFF };
+static const StencilOpState sDefaultStencilOp = { StencilOp::Keep, StencilOp::Keep, StencilOp::Keep };
+
+PipelineStateDesc::PipelineStateDesc()
+{
+	memset(static_cast<void*>(this), 0, sizeof(PipelineStateDesc));
+	depthFunc = CompareFunc::Less;
+	depthMask = true;
+	stencilFunc[0] = stencilFunc[1] = sDefaultStencilFunc;
+	stencilOp[0] = stencilOp[1] = sDefaultStencilOp;
+	stencilWriteMask[0] = stencilWriteMask[1] = 0xFFFFFFFF;
+	blendEquation = { BlendEquation::Add, BlendEquation::Add };
+	blendFunc = { BlendFunc::One, BlendFunc::Zero, BlendFunc::One, BlendFunc::Zero };
+	colorWriteMask = Vec4b(true, true, true, true);
+	cullFace = Face::Back;
+	frontFace = FrontFaceMode::CounterClockwise;
+	polygonMode = PolygonMode::Fill;
+}
+
+PipelineStateDesc& PipelineStateDesc::EnableCapability(Capability cap)
+{
+	int32_t index = CapabilityToIndex(cap);
+	if (index >= 0) {
+		managedCapabilities |= 1u << index;
+		enabledCapabilities |= 1u << index;
+	}
+	return *this;
+}
+
+PipelineStateDesc& PipelineStateDesc::DisableCapability(Capability cap)
+{
+	int32_t index = CapabilityToIndex(cap);
+	if (index >= 0) {
+		managedCapabilities |= 1u << index;
+		enabledCapabilities &= ~(1u << index);
+	}
+	return *this;
+}
+
+PipelineStateDesc& PipelineStateDesc::SetViewport(Box box)
+{
+	viewportSet = true;
+	viewport = box;
+	return *this;
+}
+
+PipelineStateDesc& PipelineStateDesc::SetScissorBox(Box box)
+{
+	scissorBoxSet = true;
+	scissorBox = box;
+	return *this;
+}
+
+template<typename T>
+static bool Differs(bool full, const T& a, const T& b)
+{
+	return full || memcmp(&a, &b, sizeof(T)) != 0;
+}
+
+static void ApplyDesc(const PipelineStateDesc& desc, const PipelineStateDesc& prev, bool full)
+{
+	for (uint32_t i = 0; i < CapabilityCount; i++) {
+		uint32_t bit = 1u << i;
+		if (!(desc.managedCapabilities & bit))
+			continue;
+		bool enabled = (desc.enabledCapabilities & bit) != 0;
+		if (full || !(prev.managedCapabilities & bit) || enabled != ((prev.enabledCapabilities & bit) != 0)) {
+			if (enabled)
+				GLUtil::EnableCapability(IndexToCapability(i));
+			else
+				GLUtil::DisableCapability(IndexToCapability(i));
+		}
+	}
+
+	if (Differs(full, desc.depthFunc, prev.depthFunc))
+		SetDepthFunc(desc.depthFunc);
+	if (Differs(full, desc.depthMask, prev.depthMask))
+		SetDepthMask(desc.depthMask != 0);
+
+	if (Differs(full, desc.stencilFunc, prev.stencilFunc)) {
+		SetStencilFunc(Face::Front, desc.stencilFunc[0].func, desc.stencilFunc[0].ref, desc.stencilFunc[0].mask);
+		SetStencilFunc(Face::Back, desc.stencilFunc[1].func, desc.stencilFunc[1].ref, desc.stencilFunc[1].mask);
+	}
+	if (Differs(full, desc.stencilOp, prev.stencilOp)) {
+		SetStencilOp(Face::Front, desc.stencilOp[0].stencilFail, desc.stencilOp[0].depthFail, desc.stencilOp[0].depthPass);
+		SetStencilOp(Face::Back, desc.stencilOp[1].stencilFail, desc.stencilOp[1].depthFail, desc.stencilOp[1].depthPass);
+	}
+	if (Differs(full, desc.stencilWriteMask, prev.stencilWriteMask)) {
+		SetStencilWriteMask(Face::Front, desc.stencilWriteMask[0]);
+		SetStencilWriteMask(Face::Back, desc.stencilWriteMask[1]);
+	}
+
+	if (Differs(full, desc.blendEquation, prev.blendEquation))
+		SetBlendEquation(desc.blendEquation.rgb, desc.blendEquation.alpha);
+	if (Differs(full, desc.blendFunc, prev.blendFunc))
+		SetBlendFunc(desc.blendFunc.srcRGB, desc.blendFunc.dstRGB, desc.blendFunc.srcAlpha, desc.blendFunc.dstAlpha);
+	if (Differs(full, desc.blendColor, prev.blendColor))
+		SetBlendColor(desc.blendColor);
+	if (Differs(full, desc.colorWriteMask, prev.colorWriteMask))
+		SetColorWriteMask(desc.colorWriteMask);
+
+	if (Differs(full, desc.cullFace, prev.cullFace))
+		SetCullFace(desc.cullFace);
+	if (Differs(full, desc.frontFace, prev.frontFace))
+		SetFrontFaceMode(desc.frontFace);
+	if (Differs(full, desc.polygonMode, prev.polygonMode))
+		SetPolygonMode(Face::FrontAndBack, desc.polygonMode);
+	if (Differs(full, desc.polygonOffset, prev.polygonOffset))
+		SetPolygonOffset(desc.polygonOffset.factor, desc.polygonOffset.units);
+
+	if (desc.viewportSet && (full || !prev.viewportSet || Differs(full, desc.viewport, prev.viewport)))
+		SetViewport(desc.viewport);
+	if (desc.scissorBoxSet && (full || !prev.scissorBoxSet || Differs(full, desc.scissorBox, prev.scissorBox)))
+		SetScissorBox(desc.scissorBox);
+}
+
+PipelineState::PipelineState() :
+	PipelineState(PipelineStateDesc())
+{}
+
+PipelineState::PipelineState(const PipelineStateDesc& desc) :
+	mDesc(desc), mHash(HashValue(desc))
+{}
+
+void PipelineState::Apply() const
+{
+	if (!sAppliedValid) {
+		ApplyAll();
+		return;
+	}
+	if (memcmp(&sApplied, &mDesc, sizeof(PipelineStateDesc)) == 0)
+		return;
+
+	ApplyDesc(mDesc, sApplied, false);
+	sApplied = mDesc;
+}
+
+void PipelineState::ApplyAll() const
+{
+	ApplyDesc(mDesc, mDesc, true);
+	sApplied = mDesc;
+	sAppliedValid = true;
+}
+
+void PipelineState::InvalidateApplied()
+{
+	sAppliedValid = false;
+}
+
+const PipelineStateDesc& PipelineState::GetDesc() const
+{
+	return mDesc;
+}
+
+uint64_t PipelineState::GetHash() const
+{
+	return mHash;
+}
+
+bool PipelineState::operator==(const PipelineState& other) const
+{
+	return mHash == other.mHash && memcmp(&mDesc, &other.mDesc, sizeof(PipelineStateDesc)) == 0;
+}
+
+bool PipelineState::operator!=(const PipelineState& other) const
+{
+	return !(*this == other);
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <GLUtil/Program.h>
+#include <GLUtil/ProgramReflection.h>
 
 #include <glad/gl.h>
 
@@ -7,6 +8,9 @@
 #include <cstring>
 
 #define ENUM(e) static_cast<GLenum>(e)
+// Skip the upload when the shadow already holds the value
+#define UNIFORM_SHADOWED(data, size) if (mShadow && !mShadow->Update(mLocation, data, size)) return *this
+#define UNIFORM_SHADOWED_MATRIX(data, size, transpose) if (mShadow && !mShadow->Update(mLocation, data, size, transpose)) return *this
 
 namespace GLUtil {
 
@@ -507,11 +511,11 @@ uint32_t ProgramUniformBlock::GetIndex() const
 }
 
 ProgramUniform::ProgramUniform() :
-	mProgram(0), mLocation(0), mIndex(0)
+	mProgram(0), mLocation(0), mIndex(0), mShadow(nullptr)
 {}
 
-ProgramUniform::ProgramUniform(uint32_t program, int32_t location, uint32_t index) :
-	mProgram(program), mLocation(location), mIndex(index)
+ProgramUniform::ProgramUniform(uint32_t program, int32_t location, uint32_t index, UniformShadow* shadow) :
+	mProgram(program), mLocation(location), mIndex(index), mShadow(shadow)
 {}
 
 int32_t ProgramUniform::GetName(int32_t bufSize, char* name) const
@@ -873,18 +877,22 @@ Mat4x3d ProgramUniform::GetDoubleMat4x3() const
 
 ProgramUniform& ProgramUniform::Set(float v)
 {
+	UNIFORM_SHADOWED(&v, sizeof(v));
 	GLUTIL_GL_CALL(glProgramUniform1f(mProgram, mLocation, v));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::Set(float x, float y)
 {
+	const float data[] = { x, y };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform2f(mProgram, mLocation, x, y));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetFloat2V(const float* v)
 {
+	UNIFORM_SHADOWED(v, 2 * sizeof(float));
 	GLUTIL_GL_CALL(glProgramUniform2fv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -896,12 +904,15 @@ ProgramUniform& ProgramUniform::Set(const Vec2f& v)
 
 ProgramUniform& ProgramUniform::Set(float x, float y, float z)
 {
+	const float data[] = { x, y, z };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform3f(mProgram, mLocation, x, y, z));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetFloat3V(const float* v)
 {
+	UNIFORM_SHADOWED(v, 3 * sizeof(float));
 	GLUTIL_GL_CALL(glProgramUniform3fv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -913,12 +924,15 @@ ProgramUniform& ProgramUniform::Set(const Vec3f& v)
 
 ProgramUniform& ProgramUniform::Set(float x, float y, float z, float w)
 {
+	const float data[] = { x, y, z, w };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform4f(mProgram, mLocation, x, y, z, w));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetFloat4V(const float* v)
 {
+	UNIFORM_SHADOWED(v, 4 * sizeof(float));
 	GLUTIL_GL_CALL(glProgramUniform4fv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -930,6 +944,7 @@ ProgramUniform& ProgramUniform::Set(const Vec4f& v)
 
 ProgramUniform& ProgramUniform::SetFloat2x2V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 4 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix2fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -941,6 +956,7 @@ ProgramUniform& ProgramUniform::Set(const Mat2f& v)
 
 ProgramUniform& ProgramUniform::SetFloat3x3V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 9 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix3fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -952,6 +968,7 @@ ProgramUniform& ProgramUniform::Set(const Mat3f& v)
 
 ProgramUniform& ProgramUniform::SetFloat4x4V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 16 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix4fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -963,6 +980,7 @@ ProgramUniform& ProgramUniform::Set(const Mat4f& v)
 
 ProgramUniform& ProgramUniform::SetFloat2x3V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 6 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix2x3fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -974,6 +992,7 @@ ProgramUniform& ProgramUniform::Set(const Mat2x3f& v)
 
 ProgramUniform& ProgramUniform::SetFloat2x4V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 8 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix2x4fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -985,6 +1004,7 @@ ProgramUniform& ProgramUniform::Set(const Mat2x4f& v)
 
 ProgramUniform& ProgramUniform::SetFloat3x2V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 6 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix3x2fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -996,6 +1016,7 @@ ProgramUniform& ProgramUniform::Set(const Mat3x2f& v)
 
 ProgramUniform& ProgramUniform::SetFloat3x4V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 12 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix3x4fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1007,6 +1028,7 @@ ProgramUniform& ProgramUniform::Set(const Mat3x4f& v)
 
 ProgramUniform& ProgramUniform::SetFloat4x2V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 8 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix4x2fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1018,6 +1040,7 @@ ProgramUniform& ProgramUniform::Set(const Mat4x2f& v)
 
 ProgramUniform& ProgramUniform::SetFloat4x3V(const float* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 12 * sizeof(float), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix4x3fv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1029,18 +1052,22 @@ ProgramUniform& ProgramUniform::Set(const Mat4x3f& v)
 
 ProgramUniform& ProgramUniform::Set(int32_t v)
 {
+	UNIFORM_SHADOWED(&v, sizeof(v));
 	GLUTIL_GL_CALL(glProgramUniform1i(mProgram, mLocation, v));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::Set(int32_t x, int32_t y)
 {
+	const int32_t data[] = { x, y };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform2i(mProgram, mLocation, x, y));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetInt2V(const int32_t* v)
 {
+	UNIFORM_SHADOWED(v, 2 * sizeof(int32_t));
 	GLUTIL_GL_CALL(glProgramUniform2iv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1052,12 +1079,15 @@ ProgramUniform& ProgramUniform::Set(const Vec2i& v)
 
 ProgramUniform& ProgramUniform::Set(int32_t x, int32_t y, int32_t z)
 {
+	const int32_t data[] = { x, y, z };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform3i(mProgram, mLocation, x, y, z));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetInt3V(const int32_t* v)
 {
+	UNIFORM_SHADOWED(v, 3 * sizeof(int32_t));
 	GLUTIL_GL_CALL(glProgramUniform3iv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1069,12 +1099,15 @@ ProgramUniform& ProgramUniform::Set(const Vec3i& v)
 
 ProgramUniform& ProgramUniform::Set(int32_t x, int32_t y, int32_t z, int32_t w)
 {
+	const int32_t data[] = { x, y, z, w };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform4i(mProgram, mLocation, x, y, z, w));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetInt4V(const int32_t* v)
 {
+	UNIFORM_SHADOWED(v, 4 * sizeof(int32_t));
 	GLUTIL_GL_CALL(glProgramUniform4iv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1087,18 +1120,22 @@ ProgramUniform& ProgramUniform::Set(const Vec4i& v)
 
 ProgramUniform& ProgramUniform::Set(uint32_t v)
 {
+	UNIFORM_SHADOWED(&v, sizeof(v));
 	GLUTIL_GL_CALL(glProgramUniform1ui(mProgram, mLocation, v));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::Set(uint32_t x, uint32_t y)
 {
+	const uint32_t data[] = { x, y };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform2ui(mProgram, mLocation, x, y));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetUnsignedInt2V(const uint32_t* v)
 {
+	UNIFORM_SHADOWED(v, 2 * sizeof(uint32_t));
 	GLUTIL_GL_CALL(glProgramUniform2uiv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1110,12 +1147,15 @@ ProgramUniform& ProgramUniform::Set(const Vec2ui& v)
 
 ProgramUniform& ProgramUniform::Set(uint32_t x, uint32_t y, uint32_t z)
 {
+	const uint32_t data[] = { x, y, z };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform3ui(mProgram, mLocation, x, y, z));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetUnsignedInt3V(const uint32_t* v)
 {
+	UNIFORM_SHADOWED(v, 3 * sizeof(uint32_t));
 	GLUTIL_GL_CALL(glProgramUniform3uiv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1127,12 +1167,15 @@ ProgramUniform& ProgramUniform::Set(const Vec3ui& v)
 
 ProgramUniform& ProgramUniform::Set(uint32_t x, uint32_t y, uint32_t z, uint32_t w)
 {
+	const uint32_t data[] = { x, y, z, w };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform4ui(mProgram, mLocation, x, y, z, w));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetUnsignedInt4V(const uint32_t* v)
 {
+	UNIFORM_SHADOWED(v, 4 * sizeof(uint32_t));
 	GLUTIL_GL_CALL(glProgramUniform4uiv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1144,18 +1187,22 @@ ProgramUniform& ProgramUniform::Set(const Vec4ui& v)
 
 ProgramUniform& ProgramUniform::Set(double v)
 {
+	UNIFORM_SHADOWED(&v, sizeof(v));
 	GLUTIL_GL_CALL(glProgramUniform1d(mProgram, mLocation, v));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::Set(double x, double y)
 {
+	const double data[] = { x, y };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform2d(mProgram, mLocation, x, y));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetDouble2V(const double* v)
 {
+	UNIFORM_SHADOWED(v, 2 * sizeof(double));
 	GLUTIL_GL_CALL(glProgramUniform2dv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1167,12 +1214,15 @@ ProgramUniform& ProgramUniform::Set(const Vec2d& v)
 
 ProgramUniform& ProgramUniform::Set(double x, double y, double z)
 {
+	const double data[] = { x, y, z };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform3d(mProgram, mLocation, x, y, z));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetDouble3V(const double* v)
 {
+	UNIFORM_SHADOWED(v, 3 * sizeof(double));
 	GLUTIL_GL_CALL(glProgramUniform3dv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1184,12 +1234,15 @@ ProgramUniform& ProgramUniform::Set(const Vec3d& v)
 
 ProgramUniform& ProgramUniform::Set(double x, double y, double z, double w)
 {
+	const double data[] = { x, y, z, w };
+	UNIFORM_SHADOWED(data, sizeof(data));
 	GLUTIL_GL_CALL(glProgramUniform4d(mProgram, mLocation, x, y, z, w));
 	return *this;
 }
 
 ProgramUniform& ProgramUniform::SetDouble4V(const double* v)
 {
+	UNIFORM_SHADOWED(v, 4 * sizeof(double));
 	GLUTIL_GL_CALL(glProgramUniform4dv(mProgram, mLocation, 1, v));
 	return *this;
 }
@@ -1201,6 +1254,7 @@ ProgramUniform& ProgramUniform::Set(const Vec4d& v)
 
 ProgramUniform& ProgramUniform::SetDouble2x2V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 4 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix2dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1212,6 +1266,7 @@ ProgramUniform& ProgramUniform::Set(const Mat2d& v)
 
 ProgramUniform& ProgramUniform::SetDouble3x3V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 9 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix3dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1223,6 +1278,7 @@ ProgramUniform& ProgramUniform::Set(const Mat3d& v)
 
 ProgramUniform& ProgramUniform::SetDouble4x4V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 16 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix4dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1234,6 +1290,7 @@ ProgramUniform& ProgramUniform::Set(const Mat4d& v)
 
 ProgramUniform& ProgramUniform::SetDouble2x3V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 6 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix2x3dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1245,6 +1302,7 @@ ProgramUniform& ProgramUniform::Set(const Mat2x3d& v)
 
 ProgramUniform& ProgramUniform::SetDouble2x4V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 8 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix2x4dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1256,6 +1314,7 @@ ProgramUniform& ProgramUniform::Set(const Mat2x4d& v)
 
 ProgramUniform& ProgramUniform::SetDouble3x2V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 6 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix3x2dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1267,6 +1326,7 @@ ProgramUniform& ProgramUniform::Set(const Mat3x2d& v)
 
 ProgramUniform& ProgramUniform::SetDouble3x4V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 12 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix3x4dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1278,6 +1338,7 @@ ProgramUniform& ProgramUniform::Set(const Mat3x4d& v)
 
 ProgramUniform& ProgramUniform::SetDouble4x2V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 8 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix4x2dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1289,6 +1350,7 @@ ProgramUniform& ProgramUniform::Set(const Mat4x2d& v)
 
 ProgramUniform& ProgramUniform::SetDouble4x3V(const double* v, bool transpose)
 {
+	UNIFORM_SHADOWED_MATRIX(v, 12 * sizeof(double), transpose);
 	GLUTIL_GL_CALL(glProgramUniformMatrix4x3dv(mProgram, mLocation, 1, transpose, v));
 	return *this;
 }
@@ -1313,6 +1375,11 @@ uint32_t ProgramUniform::GetIndex() const
 	return mIndex;
 }
 
+UniformShadow* ProgramUniform::GetShadow() const
+{
+	return mShadow;
+}
+
 ProgramAtomicCounterBuffer::ProgramAtomicCounterBuffer() :
 	mProgram(0), mBufferIndex(0)
 {}
@@ -1607,6 +1674,11 @@ bool Program::Link()
 	return IsLinked();
 }
 
+void Program::LinkAsync()
+{
+	GLUTIL_GL_CALL(glLinkProgram(*this));
+}
+
 bool Program::Validate()
 {
 	GLUTIL_GL_CALL(glValidateProgram(*this));
@@ -1711,6 +1783,13 @@ ProgramResource Program::GetResource(ProgramInterface interface, const char* nam
 	return ProgramResource(*this, interface, GetResourceIndex(interface, name));
 }
 
+int32_t Program::GetNumActiveResources(ProgramInterface interface) const
+{
+	int32_t count = 0;
+	GLUTIL_GL_CALL(glGetProgramInterfaceiv(*this, ENUM(interface), GL_ACTIVE_RESOURCES, &count));
+	return count;
+}
+
 Program& Program::BindAttribLocation(uint32_t index, const char* name)
 {
 	GLUTIL_GL_CALL(glBindAttribLocation(*this, index, name));
@@ -1847,6 +1926,14 @@ bool Program::IsLinked() const
 	return GetPropI(ProgramProp::LinkStatus) == GL_TRUE;
 }
 
+// Without KHR_parallel_shader_compile the status query simply blocks
+bool Program::IsCompletionReady() const
+{
+	if (!GLAD_GL_KHR_parallel_shader_compile && !GLAD_GL_ARB_parallel_shader_compile)
+		return true;
+	return GetPropI(ProgramProp::CompletionStatus) == GL_TRUE;
+}
+
 bool Program::IsValidated() const
 {
 	return GetPropI(ProgramProp::ValidateStatus) == GL_TRUE;
@@ -0,0 +1,323 @@
+#include <GLUtil/ProgramCache.h>
+#include <GLUtil/Hash.h>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <glad/gl.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace GLUtil {
+
+static const uint32_t CacheMagic = 0x43504C47; // "GLPC"
+static const uint32_t CacheVersion = 1;
+
+struct CacheFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t driverHash;
+	uint32_t entryCount;
+	uint32_t reserved;
+};
+
+struct CacheEntryHeader
+{
+	uint64_t key;
+	uint32_t format;
+	int32_t length;
+};
+
+static size_t PadEntry(size_t length)
+{
+	return (8 - (length & 7)) & 7;
+}
+
+static const uint8_t* MapFile(const char* path, size_t* size)
+{
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return nullptr;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return nullptr;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return nullptr;
+	void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!ptr)
+		return nullptr;
+	*size = static_cast<size_t>(fileSize.QuadPart);
+	return static_cast<const uint8_t*>(ptr);
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return nullptr;
+	}
+	void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (ptr == MAP_FAILED)
+		return nullptr;
+	*size = static_cast<size_t>(st.st_size);
+	return static_cast<const uint8_t*>(ptr);
+#endif
+}
+
+static void UnmapFile(const uint8_t* ptr, size_t size)
+{
+#if defined(_WIN32)
+	UnmapViewOfFile(ptr);
+#else
+	munmap(const_cast<uint8_t*>(ptr), size);
+#endif
+}
+
+ProgramCache::ProgramCache(const char* path) :
+	mPath(path), mDriverHash(GetDriverHash()), mMapped(nullptr), mMappedSize(0), mDirty(false), mHits(0), mMisses(0)
+{
+	Open();
+}
+
+ProgramCache::~ProgramCache()
+{
+	Save();
+	Close();
+}
+
+void ProgramCache::Open()
+{
+	mMapped = MapFile(mPath.c_str(), &mMappedSize);
+	mDirty = false;
+	if (!mMapped)
+		return;
+
+	CacheFileHeader header;
+	if (mMappedSize < sizeof(header)) {
+		Close();
+		return;
+	}
+	memcpy(&header, mMapped, sizeof(header));
+	if (header.magic != CacheMagic || header.version != CacheVersion || header.driverHash != mDriverHash) {
+		Close();
+		return;
+	}
+
+	size_t offset = sizeof(header);
+	for (uint32_t i = 0; i < header.entryCount; i++) {
+		CacheEntryHeader entryHeader;
+		if (offset + sizeof(entryHeader) > mMappedSize)
+			break;
+		memcpy(&entryHeader, mMapped + offset, sizeof(entryHeader));
+		offset += sizeof(entryHeader);
+		if (entryHeader.length <= 0 || offset + entryHeader.length > mMappedSize)
+			break;
+
+		Entry& entry = mEntries[entryHeader.key];
+		entry.format = entryHeader.format;
+		entry.length = entryHeader.length;
+		entry.mapped = mMapped + offset;
+		offset += entryHeader.length + PadEntry(entryHeader.length);
+	}
+}
+
+void ProgramCache::Close()
+{
+	mEntries.clear();
+	if (mMapped) {
+		UnmapFile(mMapped, mMappedSize);
+		mMapped = nullptr;
+		mMappedSize = 0;
+	}
+}
+
+// Copies the mapped binaries into memory and unmaps the file, the entries stay
+void ProgramCache::Detach()
+{
+	for (auto& pair : mEntries) {
+		Entry& entry = pair.second;
+		if (entry.mapped) {
+			entry.data.assign(entry.mapped, entry.mapped + entry.length);
+			entry.mapped = nullptr;
+		}
+	}
+	if (mMapped) {
+		UnmapFile(mMapped, mMappedSize);
+		mMapped = nullptr;
+		mMappedSize = 0;
+	}
+}
+
+bool ProgramCache::Compile(Program& program, const ProgramSource* sources, uint32_t count, const char* defines)
+{
+	std::vector<Shader> shaders;
+	shaders.reserve(count);
+	for (uint32_t i = 0; i < count; i++) {
+		Shader shader(sources[i].type);
+		shader.Source(sources[i].source, defines);
+		if (!shader.Compile()) {
+			mInfoLog = shader.GetInfoLog();
+			return false;
+		}
+		program.AttachShader(shader);
+		shaders.push_back(std::move(shader));
+	}
+
+	program.SetBinaryRetrievableHint(true);
+	bool linked = program.Link();
+	for (const Shader& shader : shaders)
+		program.DetachShader(shader);
+	if (!linked)
+		mInfoLog = program.GetInfoLog();
+	return linked;
+}
+
+Program ProgramCache::Load(const ProgramSource* sources, uint32_t count, const char* defines)
+{
+	Program program;
+	uint64_t key = Hash(sources, count, defines, mDriverHash);
+
+	auto it = mEntries.find(key);
+	if (it != mEntries.end()) {
+		const Entry& entry = it->second;
+		if (program.Binary(entry.format, entry.mapped ? entry.mapped : entry.data.data(), entry.length)) {
+			mHits++;
+			return program;
+		}
+		// Rejected by the driver, rebuild it from source
+		mEntries.erase(it);
+		mDirty = true;
+	}
+
+	mMisses++;
+	if (!Compile(program, sources, count, defines))
+		return program;
+
+	ProgramBinary binary = program.GetBinary();
+	if (binary.GetLength() > 0) {
+		const uint8_t* data = static_cast<const uint8_t*>(binary.GetBinary());
+		Entry& entry = mEntries[key];
+		entry.format = binary.GetFormat();
+		entry.length = binary.GetLength();
+		entry.mapped = nullptr;
+		entry.data.assign(data, data + binary.GetLength());
+		mDirty = true;
+	}
+	return program;
+}
+
+Program ProgramCache::Load(std::initializer_list<ProgramSource> sources, const char* defines)
+{
+	return Load(sources.begin(), static_cast<uint32_t>(sources.size()), defines);
+}
+
+uint64_t ProgramCache::Hash(const ProgramSource* sources, uint32_t count, const char* defines, uint64_t driverHash)
+{
+	uint64_t hash = HashValue(driverHash);
+	for (uint32_t i = 0; i < count; i++) {
+		hash = HashValue(sources[i].type, hash);
+		hash = HashBytes(sources[i].source, strlen(sources[i].source) + 1, hash);
+	}
+	if (defines)
+		hash = HashBytes(defines, strlen(defines) + 1, hash);
+	return hash;
+}
+
+uint64_t ProgramCache::GetDriverHash()
+{
+	uint64_t hash = FNV1aOffset;
+	const GLenum names[3] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+	for (GLenum name : names) {
+		GLUTIL_GL_CALL(const char* str = reinterpret_cast<const char*>(glGetString(name)));
+		if (str)
+			hash = HashBytes(str, strlen(str) + 1, hash);
+	}
+	return hash;
+}
+
+bool ProgramCache::Save()
+{
+	if (!mDirty)
+		return true;
+
+	std::string tmpPath = mPath + ".tmp";
+	FILE* file = fopen(tmpPath.c_str(), "wb");
+	if (!file)
+		return false;
+
+	static const uint8_t padding[8] = {};
+	CacheFileHeader header = { CacheMagic, CacheVersion, mDriverHash, static_cast<uint32_t>(mEntries.size()), 0 };
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+	for (const auto& pair : mEntries) {
+		const Entry& entry = pair.second;
+		CacheEntryHeader entryHeader = { pair.first, entry.format, entry.length };
+		size_t pad = PadEntry(entry.length);
+		ok = ok && fwrite(&entryHeader, sizeof(entryHeader), 1, file) == 1;
+		ok = ok && fwrite(entry.mapped ? entry.mapped : entry.data.data(), 1, entry.length, file) == static_cast<size_t>(entry.length);
+		ok = ok && fwrite(padding, 1, pad, file) == pad;
+	}
+	ok = fclose(file) == 0 && ok;
+	if (!ok) {
+		remove(tmpPath.c_str());
+		return false;
+	}
+
+	// The file is replaced in one step. If that fails the old file and the entries in
+	// memory stay, and the cache stays dirty so a later Save() retries.
+#if defined(_WIN32)
+	// A mapped file can't be replaced
+	Detach();
+	bool replaced = MoveFileExA(tmpPath.c_str(), mPath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	// The mapping of the old file stays valid after the rename
+	bool replaced = rename(tmpPath.c_str(), mPath.c_str()) == 0;
+#endif
+	if (!replaced) {
+		remove(tmpPath.c_str());
+		return false;
+	}
+	Close();
+	Open();
+	return true;
+}
+
+void ProgramCache::Clear()
+{
+	Close();
+	mDirty = true;
+}
+
+uint32_t ProgramCache::GetHits() const
+{
+	return mHits;
+}
+
+uint32_t ProgramCache::GetMisses() const
+{
+	return mMisses;
+}
+
+const std::string& ProgramCache::GetInfoLog() const
+{
+	return mInfoLog;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include <GLUtil/ProgramReflection.h>
+
+#include <glad/gl.h>
+
+#include <cstring>
+#include <string>
+
+namespace GLUtil {
+
+// Adds the name without the trailing "[0]" of arrays as well
+static void AddLookup(std::unordered_map<uint64_t, uint32_t>& lookup, const std::string& name, uint32_t slot)
+{
+	lookup[HashString(name.c_str())] = slot;
+	size_t length = name.size();
+	if (length > 3 && name.compare(length - 3, 3, "[0]") == 0)
+		lookup.emplace(HashString(name.substr(0, length - 3).c_str()), slot);
+}
+
+UniformShadow::UniformShadow() :
+	mUploads(0), mSkipped(0)
+{}
+
+UniformShadow::UniformShadow(const ProgramReflection& reflection) :
+	mUploads(0), mSkipped(0)
+{
+	Build(reflection);
+}
+
+// Array elements have consecutive locations, each gets its own slot
+void UniformShadow::Build(const ProgramReflection& reflection)
+{
+	mSlots.clear();
+	mData.clear();
+
+	uint32_t offset = 0;
+	for (const ReflectedUniform& uniform : reflection.GetUniforms()) {
+		uint32_t size = GetDataTypeSize(uniform.type);
+		if (uniform.location < 0 || uniform.blockIndex >= 0 || !size)
+			continue;
+
+		int32_t count = uniform.arraySize > 0 ? uniform.arraySize : 1;
+		if (mSlots.size() < static_cast<size_t>(uniform.location + count))
+			mSlots.resize(uniform.location + count, { 0, 0, false });
+		for (int32_t i = 0; i < count; i++) {
+			mSlots[uniform.location + i] = { offset, size, false };
+			offset += size;
+		}
+	}
+	mData.resize(offset);
+}
+
+bool UniformShadow::Update(int32_t location, const void* data, uint32_t size, bool transpose)
+{
+	mUploads++;
+	if (location < 0 || static_cast<size_t>(location) >= mSlots.size())
+		return true;
+
+	Slot& slot = mSlots[location];
+	if (slot.size != size || transpose) {
+		slot.valid = false;
+		return true;
+	}
+
+	uint8_t* shadow = mData.data() + slot.offset;
+	if (slot.valid && memcmp(shadow, data, size) == 0) {
+		mUploads--;
+		mSkipped++;
+		return false;
+	}
+	memcpy(shadow, data, size);
+	slot.valid = true;
+	return true;
+}
+
+void UniformShadow::Invalidate()
+{
+	for (Slot& slot : mSlots)
+		slot.valid = false;
+}
+
+void UniformShadow::Invalidate(int32_t location)
+{
+	if (location >= 0 && static_cast<size_t>(location) < mSlots.size())
+		mSlots[location].valid = false;
+}
+
+uint64_t UniformShadow::GetUploads() const
+{
+	return mUploads;
+}
+
+uint64_t UniformShadow::GetSkipped() const
+{
+	return mSkipped;
+}
+
+void UniformShadow::ResetCounters()
+{
+	mUploads = 0;
+	mSkipped = 0;
+}
+
+ProgramReflection::ProgramReflection() :
+	mProgram(0)
+{}
+
+ProgramReflection::ProgramReflection(const Program& program) :
+	mProgram(0)
+{
+	Build(program);
+}
+
+ProgramReflection::~ProgramReflection()
+{}
+
+void ProgramReflection::ReflectBlocks(const Program& program, ProgramInterface interface, std::vector<ReflectedBlock>& blocks, std::unordered_map<uint64_t, uint32_t>& lookup)
+{
+	static const ProgramResourceProp props[] = {
+		ProgramResourceProp::BufferBinding,
+		ProgramResourceProp::BufferDataSize
+	};
+
+	int32_t count = program.GetNumActiveResources(interface);
+	blocks.reserve(count);
+	for (int32_t i = 0; i < count; i++) {
+		ProgramResource resource(program, interface, i);
+		int32_t values[2] = {};
+		resource.GetProps(2, props, 2, nullptr, values);
+
+		ReflectedBlock block;
+		block.name = resource.GetName();
+		block.hash = HashString(block.name.c_str());
+		block.index = i;
+		block.binding = values[0];
+		block.dataSize = values[1];
+		AddLookup(lookup, block.name, static_cast<uint32_t>(blocks.size()));
+		blocks.push_back(std::move(block));
+	}
+}
+
+// Uniforms and buffer variables share the props, buffer variables report location -1
+void ProgramReflection::ReflectVariables(const Program& program, ProgramInterface interface, std::vector<ReflectedUniform>& variables, std::unordered_map<uint64_t, uint32_t>& lookup)
+{
+	static const ProgramResourceProp props[] = {
+		ProgramResourceProp::Type,
+		ProgramResourceProp::ArraySize,
+		ProgramResourceProp::BlockIndex,
+		ProgramResourceProp::Offset,
+		ProgramResourceProp::ArrayStride,
+		ProgramResourceProp::MatrixStride,
+		ProgramResourceProp::IsRowMajor,
+		ProgramResourceProp::Location
+	};
+	int32_t propCount = interface == ProgramInterface::Uniform ? 8 : 7;
+
+	int32_t count = program.GetNumActiveResources(interface);
+	variables.reserve(count);
+	for (int32_t i = 0; i < count; i++) {
+		ProgramResource resource(program, interface, i);
+		int32_t values[8] = { 0, 0, 0, 0, 0, 0, 0, -1 };
+		resource.GetProps(propCount, props, propCount, nullptr, values);
+
+		ReflectedUniform variable;
+		variable.name = resource.GetName();
+		variable.hash = HashString(variable.name.c_str());
+		variable.location = values[7];
+		variable.index = i;
+		variable.type = static_cast<DataType>(values[0]);
+		variable.arraySize = values[1];
+		variable.blockIndex = values[2];
+		variable.offset = values[3];
+		variable.arrayStride = values[4];
+		variable.matrixStride = values[5];
+		variable.rowMajor = values[6] != 0;
+		AddLookup(lookup, variable.name, static_cast<uint32_t>(variables.size()));
+		variables.push_back(std::move(variable));
+	}
+}
+
+void ProgramReflection::Build(const Program& program)
+{
+	Clear();
+	mProgram = program;
+
+	ReflectVariables(program, ProgramInterface::Uniform, mUniforms, mUniformLookup);
+	ReflectVariables(program, ProgramInterface::BufferVariable, mBufferVariables, mBufferVariableLookup);
+	ReflectBlocks(program, ProgramInterface::UniformBlock, mUniformBlocks, mUniformBlockLookup);
+	ReflectBlocks(program, ProgramInterface::ShaderStorageBlock, mStorageBlocks, mStorageBlockLookup);
+
+	static const ProgramResourceProp attributeProps[] = {
+		ProgramResourceProp::Location,
+		ProgramResourceProp::Type,
+		ProgramResourceProp::ArraySize
+	};
+
+	int32_t attributeCount = program.GetNumActiveResources(ProgramInterface::ProgramInput);
+	mAttributes.reserve(attributeCount);
+	for (int32_t i = 0; i < attributeCount; i++) {
+		ProgramResource resource(program, ProgramInterface::ProgramInput, i);
+		int32_t values[3] = {};
+		resource.GetProps(3, attributeProps, 3, nullptr, values);
+
+		ReflectedAttribute attribute;
+		attribute.name = resource.GetName();
+		attribute.hash = HashString(attribute.name.c_str());
+		attribute.location = values[0];
+		attribute.type = static_cast<DataType>(values[1]);
+		attribute.arraySize = values[2];
+		AddLookup(mAttributeLookup, attribute.name, static_cast<uint32_t>(mAttributes.size()));
+		mAttributes.push_back(std::move(attribute));
+	}
+
+	if (mShadow)
+		mShadow->Build(*this);
+}
+
+void ProgramReflection::Clear()
+{
+	mProgram = 0;
+	mUniforms.clear();
+	mUniformBlocks.clear();
+	mStorageBlocks.clear();
+	mBufferVariables.clear();
+	mAttributes.clear();
+	mUniformLookup.clear();
+	mUniformBlockLookup.clear();
+	mStorageBlockLookup.clear();
+	mBufferVariableLookup.clear();
+	mAttributeLookup.clear();
+}
+
+void ProgramReflection::EnableShadow(bool enable)
+{
+	if (!enable)
+		mShadow.reset();
+	else if (!mShadow)
+		mShadow.reset(new UniformShadow(*this));
+}
+
+UniformShadow* ProgramReflection::GetShadow() const
+{
+	return mShadow.get();
+}
+
+const ReflectedUniform* ProgramReflection::FindUniform(uint64_t hash) const
+{
+	auto it = mUniformLookup.find(hash);
+	return it != mUniformLookup.end() ? &mUniforms[it->second] : nullptr;
+}
+
+const ReflectedBlock* ProgramReflection::FindUniformBlock(uint64_t hash) const
+{
+	auto it = mUniformBlockLookup.find(hash);
+	return it != mUniformBlockLookup.end() ? &mUniformBlocks[it->second] : nullptr;
+}
+
+const ReflectedBlock* ProgramReflection::FindStorageBlock(uint64_t hash) const
+{
+	auto it = mStorageBlockLookup.find(hash);
+	return it != mStorageBlockLookup.end() ? &mStorageBlocks[it->second] : nullptr;
+}
+
+const ReflectedUniform* ProgramReflection::FindBufferVariable(uint64_t hash) const
+{
+	auto it = mBufferVariableLookup.find(hash);
+	return it != mBufferVariableLookup.end() ? &mBufferVariables[it->second] : nullptr;
+}
+
+const ReflectedAttribute* ProgramReflection::FindAttribute(uint64_t hash) const
+{
+	auto it = mAttributeLookup.find(hash);
+	return it != mAttributeLookup.end() ? &mAttributes[it->second] : nullptr;
+}
+
+int32_t ProgramReflection::GetUniformLocation(uint64_t hash) const
+{
+	const ReflectedUniform* uniform = FindUniform(hash);
+	return uniform ? uniform->location : -1;
+}
+
+int32_t ProgramReflection::GetAttribLocation(uint64_t hash) const
+{
+	const ReflectedAttribute* attribute = FindAttribute(hash);
+	return attribute ? attribute->location : -1;
+}
+
+ProgramUniform ProgramReflection::GetUniform(uint64_t hash) const
+{
+	const ReflectedUniform* uniform = FindUniform(hash);
+	if (!uniform)
+		return ProgramUniform(mProgram, -1, GL_INVALID_INDEX);
+	return ProgramUniform(mProgram, uniform->location, uniform->index, mShadow.get());
+}
+
+ProgramUniformBlock ProgramReflection::GetUniformBlock(uint64_t hash) const
+{
+	const ReflectedBlock* block = FindUniformBlock(hash);
+	return ProgramUniformBlock(mProgram, block ? block->index : GL_INVALID_INDEX);
+}
+
+const std::vector<ReflectedUniform>& ProgramReflection::GetUniforms() const
+{
+	return mUniforms;
+}
+
+const std::vector<ReflectedBlock>& ProgramReflection::GetUniformBlocks() const
+{
+	return mUniformBlocks;
+}
+
+const std::vector<ReflectedBlock>& ProgramReflection::GetStorageBlocks() const
+{
+	return mStorageBlocks;
+}
+
+const std::vector<ReflectedUniform>& ProgramReflection::GetBufferVariables() const
+{
+	return mBufferVariables;
+}
+
+const std::vector<ReflectedAttribute>& ProgramReflection::GetAttributes() const
+{
+	return mAttributes;
+}
+
+uint32_t ProgramReflection::GetProgram() const
+{
+	return mProgram;
+}
+
+} // namespace GLUtil
\ No newline at end of file
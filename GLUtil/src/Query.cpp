@@ -0,0 +1,78 @@
+#include <GLUtil/Query.h>
+
+#include <glad/gl.h>
+
+#define ENUM(e) static_cast<GLenum>(e)
+
+namespace GLUtil {
+
+Query::Query(uint32_t query) :
+	GLObject(query)
+{}
+
+Query::~Query()
+{
+	if (*this) {
+		GLUTIL_GL_CALL(glDeleteQueries(1, GetIDPtr()));
+	}
+}
+
+Query Query::Create(QueryTarget target)
+{
+	uint32_t query = 0;
+	GLUTIL_GL_CALL(glCreateQueries(ENUM(target), 1, &query));
+	return Query(query);
+}
+
+Query Query::Gen()
+{
+	uint32_t query = 0;
+	GLUTIL_GL_CALL(glGenQueries(1, &query));
+	return Query(query);
+}
+
+void Query::Begin(QueryTarget target) const
+{
+	GLUTIL_GL_CALL(glBeginQuery(ENUM(target), *this));
+}
+
+void Query::End(QueryTarget target)
+{
+	GLUTIL_GL_CALL(glEndQuery(ENUM(target)));
+}
+
+void Query::Timestamp() const
+{
+	GLUTIL_GL_CALL(glQueryCounter(*this, GL_TIMESTAMP));
+}
+
+bool Query::IsResultAvailable() const
+{
+	uint32_t available = GL_FALSE;
+	GLUTIL_GL_CALL(glGetQueryObjectuiv(*this, GL_QUERY_RESULT_AVAILABLE, &available));
+	return available != GL_FALSE;
+}
+
+uint64_t Query::GetResult() const
+{
+	uint64_t result = 0;
+	GLUTIL_GL_CALL(glGetQueryObjectui64v(*this, GL_QUERY_RESULT, &result));
+	return result;
+}
+
+bool Query::GetResult(uint64_t* result) const
+{
+	if (!IsResultAvailable())
+		return false;
+	*result = GetResult();
+	return true;
+}
+
+uint64_t GetTimestamp()
+{
+	int64_t timestamp = 0;
+	GLUTIL_GL_CALL(glGetInteger64v(GL_TIMESTAMP, &timestamp));
+	return static_cast<uint64_t>(timestamp);
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <GLUtil/Readback.h>
+
+#include <glad/gl.h>
+
+#define ENUM(e) static_cast<GLenum>(e)
+
+namespace GLUtil {
+
+struct ReadbackState
+{
+	Fence fence;
+	const uint8_t* data;
+	intptr_t size;
+	uint32_t handle;
+	bool ready;
+	ReadbackCallback callback;
+};
+
+ReadbackTicket::ReadbackTicket()
+{}
+
+ReadbackTicket::ReadbackTicket(std::shared_ptr<ReadbackState> state) :
+	mState(std::move(state))
+{}
+
+bool ReadbackTicket::IsReady() const
+{
+	if (!mState)
+		return false;
+	if (!mState->ready && mState->fence.IsSignaled()) {
+		mState->fence.Delete();
+		mState->ready = true;
+	}
+	return mState->ready;
+}
+
+bool ReadbackTicket::Wait() const
+{
+	if (!mState)
+		return false;
+	if (!mState->ready) {
+		if (!mState->fence.Wait())
+			return false;
+		mState->fence.Delete();
+		mState->ready = true;
+	}
+	return true;
+}
+
+const void* ReadbackTicket::GetData() const
+{
+	return IsReady() ? mState->data : nullptr;
+}
+
+intptr_t ReadbackTicket::GetSize() const
+{
+	return mState ? mState->size : 0;
+}
+
+bool ReadbackTicket::IsValid() const
+{
+	return mState != nullptr;
+}
+
+AsyncReadback::AsyncReadback(intptr_t stagingSize) :
+	mMapped(nullptr), mAllocator(static_cast<uint32_t>(stagingSize / Granularity)), mUpdating(false)
+{
+	intptr_t size = static_cast<intptr_t>(mAllocator.GetSize()) * Granularity;
+	mStaging.Storage(size, nullptr, { BufferStorageFlags::MapRead, BufferStorageFlags::MapPersistent, BufferStorageFlags::MapCoherent, BufferStorageFlags::ClientStorage });
+	mMapped = static_cast<uint8_t*>(mStaging.MapRange(0, size, { BufferAccessFlags::Read, BufferAccessFlags::Persistent, BufferAccessFlags::Coherent }));
+}
+
+AsyncReadback::~AsyncReadback()
+{
+	Finish();
+	if (mMapped)
+		mStaging.Unmap();
+}
+
+// A full staging buffer first gets back the memory of reads nobody holds anymore
+std::shared_ptr<ReadbackState> AsyncReadback::Reserve(intptr_t size, ReadbackCallback callback)
+{
+	if (!mMapped || size <= 0)
+		return nullptr;
+
+	uint32_t units = static_cast<uint32_t>((size + Granularity - 1) / Granularity);
+	uint32_t offset = 0;
+	uint32_t handle = mAllocator.Allocate(units, &offset);
+	if (handle == TlsfAllocator::Invalid) {
+		Update();
+		handle = mAllocator.Allocate(units, &offset);
+		if (handle == TlsfAllocator::Invalid)
+			return nullptr;
+	}
+
+	std::shared_ptr<ReadbackState> state = std::make_shared<ReadbackState>();
+	state->data = mMapped + static_cast<intptr_t>(offset) * Granularity;
+	state->size = size;
+	state->handle = handle;
+	state->ready = false;
+	state->callback = std::move(callback);
+	return state;
+}
+
+ReadbackTicket AsyncReadback::Submit(std::shared_ptr<ReadbackState> state)
+{
+	state->fence = Fence::Create();
+	mPending.push_back(state);
+	return ReadbackTicket(std::move(state));
+}
+
+ReadbackTicket AsyncReadback::ReadImage(const Texture& texture, int32_t level, Vec3i offset, Vec3i size, TextureBaseFormat format, DataType type, int32_t bufSize, ReadbackCallback callback)
+{
+	std::shared_ptr<ReadbackState> state = Reserve(bufSize, std::move(callback));
+	if (!state)
+		return ReadbackTicket();
+
+	BufferBind bind(BufferTarget::PixelPack, mStaging);
+	void* pixels = reinterpret_cast<void*>(state->data - mMapped);
+	GLUTIL_GL_CALL(glGetTextureSubImage(texture, level, offset.x, offset.y, offset.z, size.x, size.y, size.z, ENUM(format), ENUM(type), bufSize, pixels));
+	return Submit(std::move(state));
+}
+
+ReadbackTicket AsyncReadback::ReadPixels(Vec2i offset, Vec2i size, TextureBaseFormat format, DataType type, int32_t bufSize, ReadbackCallback callback)
+{
+	std::shared_ptr<ReadbackState> state = Reserve(bufSize, std::move(callback));
+	if (!state)
+		return ReadbackTicket();
+
+	BufferBind bind(BufferTarget::PixelPack, mStaging);
+	void* pixels = reinterpret_cast<void*>(state->data - mMapped);
+	GLUTIL_GL_CALL(glReadnPixels(offset.x, offset.y, size.x, size.y, ENUM(format), ENUM(type), bufSize, pixels));
+	return Submit(std::move(state));
+}
+
+ReadbackTicket AsyncReadback::ReadBuffer(uint32_t buffer, intptr_t offset, intptr_t size, ReadbackCallback callback)
+{
+	std::shared_ptr<ReadbackState> state = Reserve(size, std::move(callback));
+	if (!state)
+		return ReadbackTicket();
+
+	CopyBufferSubData(buffer, mStaging, offset, state->data - mMapped, size);
+	return Submit(std::move(state));
+}
+
+// Callbacks may start new reads, which re-enter through Reserve(). They run from a
+// copy of the completed reads and a nested call only reclaims memory.
+uint32_t AsyncReadback::Update()
+{
+	if (!mUpdating) {
+		std::vector<std::shared_ptr<ReadbackState>> completed;
+		for (const std::shared_ptr<ReadbackState>& state : mPending) {
+			if (state->callback && ReadbackTicket(state).IsReady())
+				completed.push_back(state);
+		}
+
+		mUpdating = true;
+		for (const std::shared_ptr<ReadbackState>& state : completed) {
+			ReadbackCallback callback = std::move(state->callback);
+			state->callback = nullptr;
+			callback(state->data, state->size);
+		}
+		mUpdating = false;
+	}
+
+	uint32_t inFlight = 0;
+	for (size_t i = 0; i < mPending.size();) {
+		std::shared_ptr<ReadbackState>& state = mPending[i];
+		if (!ReadbackTicket(state).IsReady()) {
+			inFlight++;
+			i++;
+			continue;
+		}
+
+		// Kept while a callback is still to run or a ticket refers to the data
+		if (state->callback || state.use_count() > 1) {
+			i++;
+			continue;
+		}
+		mAllocator.Free(state->handle);
+		state->data = nullptr;
+		state = std::move(mPending.back());
+		mPending.pop_back();
+	}
+	return inFlight;
+}
+
+void AsyncReadback::Finish()
+{
+	for (const std::shared_ptr<ReadbackState>& state : mPending)
+		ReadbackTicket(state).Wait();
+	Update();
+}
+
+uint32_t AsyncReadback::GetPendingCount() const
+{
+	return static_cast<uint32_t>(mPending.size());
+}
+
+intptr_t AsyncReadback::GetStagingUsed() const
+{
+	return static_cast<intptr_t>(mAllocator.GetSize() - mAllocator.GetFreeSize()) * Granularity;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <GLUtil/ResourcePool.h>
+
+#include <cstring>
+
+namespace GLUtil {
+
+bool TextureDesc::operator==(const TextureDesc& other) const
+{
+	return memcmp(this, &other, sizeof(TextureDesc)) == 0;
+}
+
+bool TextureDesc::operator!=(const TextureDesc& other) const
+{
+	return !(*this == other);
+}
+
+static constexpr intptr_t MinBufferSizeClass = 256;
+
+BufferPool::BufferPool()
+{}
+
+intptr_t BufferPool::GetSizeClass(intptr_t size)
+{
+	intptr_t sizeClass = MinBufferSizeClass;
+	while (sizeClass < size)
+		sizeClass <<= 1;
+	return sizeClass;
+}
+
+Buffer BufferPool::Acquire(intptr_t size, Flags<BufferStorageFlags> flags)
+{
+	BufferPoolKey key = { GetSizeClass(size), flags.AsInt(), 0 };
+	Buffer buffer(0u);
+	if (Take(key, &buffer))
+		return buffer;
+
+	buffer = Buffer();
+	buffer.Storage(key.size, nullptr, flags);
+	Track(key, buffer);
+	return buffer;
+}
+
+TexturePool::TexturePool()
+{}
+
+Texture TexturePool::Acquire(const TextureDesc& desc)
+{
+	Texture texture(0u);
+	if (Take(desc, &texture))
+		return texture;
+
+	texture = Texture(desc.target);
+	switch (desc.target) {
+		case TextureTarget::Tex1D:
+			texture.Storage1D(desc.levels, desc.format, desc.size.x);
+			break;
+		case TextureTarget::Tex3D:
+		case TextureTarget::Tex2DArray:
+		case TextureTarget::TexCubeMapArray:
+			texture.Storage3D(desc.levels, desc.format, desc.size);
+			break;
+		case TextureTarget::Tex2DMultisample:
+			texture.Storage2DMultisample(desc.samples, desc.format, { desc.size.x, desc.size.y }, true);
+			break;
+		case TextureTarget::Tex2DMultisampleArray:
+			texture.Storage3DMultisample(desc.samples, desc.format, desc.size, true);
+			break;
+		default:
+			texture.Storage2D(desc.levels, desc.format, { desc.size.x, desc.size.y });
+			break;
+	}
+	Track(desc, texture);
+	return texture;
+}
+
+Texture TexturePool::Acquire(TextureTarget target, TextureInternalFormat format, Vec3i size, int32_t levels)
+{
+	TextureDesc desc;
+	memset(static_cast<void*>(&desc), 0, sizeof(TextureDesc));
+	desc.target = target;
+	desc.format = format;
+	desc.size = size;
+	desc.levels = levels;
+	return Acquire(desc);
+}
+
+} // namespace GLUtil
\ No newline at end of file
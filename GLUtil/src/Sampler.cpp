@@ -1,4 +1,5 @@
 #include <GLUtil/Sampler.h>
+#include <GLUtil/StateCache.h>
 
 #include <glad/gl.h>
 
@@ -13,6 +14,8 @@ Sampler::Sampler(uint32_t sampler) :
 Sampler::~Sampler()
 {
 	if (*this) {
+		if (StateCache* cache = StateCache::GetCurrent())
+			cache->ResetSampler(*this);
 		GLUTIL_GL_CALL(glDeleteSamplers(1, GetIDPtr()));
 	}
 }
@@ -33,7 +36,7 @@ Sampler Sampler::Gen()
 
 void Sampler::Bind(uint32_t unit) const
 {
-	GLUTIL_GL_CALL(glBindSampler(unit, *this));
+	BindSampler(unit, *this);
 }
 
 Sampler& Sampler::SetParamF(SamplerParam pname, float value)
@@ -92,6 +95,11 @@ Sampler& Sampler::SetMaxLod(float maxLod)
 	return SetParamF(SamplerParam::MaxLod, maxLod);
 }
 
+Sampler& Sampler::SetLodBias(float lodBias)
+{
+	return SetParamF(SamplerParam::LodBias, lodBias);
+}
+
 Sampler& Sampler::SetWrapS(TextureWrap wrap)
 {
 	return SetParamI(SamplerParam::WrapS, ENUM(wrap));
@@ -191,6 +199,11 @@ float Sampler::GetMaxLod() const
 	return GetParamF(SamplerParam::MaxLod);
 }
 
+float Sampler::GetLodBias() const
+{
+	return GetParamF(SamplerParam::LodBias);
+}
+
 TextureWrap Sampler::GetWrapS() const
 {
 	return static_cast<TextureWrap>(GetParamI(SamplerParam::WrapS));
@@ -244,4 +257,35 @@ CompareFunc Sampler::GetCompareFunc() const
 	return static_cast<CompareFunc>(GetParamI(SamplerParam::CompareFunc));
 }
 
+void BindSampler(uint32_t unit, uint32_t sampler)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		CachedValue<uint32_t>* cached = cache->GetSamplerBinding(unit);
+		if (cached && !cache->Update(*cached, sampler))
+			return;
+	}
+	GLUTIL_GL_CALL(glBindSampler(unit, sampler));
+}
+
+void BindSamplers(uint32_t first, int32_t count, const uint32_t* samplers)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		uint32_t begin, end;
+		CachedValue<uint32_t>* cached = cache->GetSamplerBinding(0);
+		auto valueAt = [&](uint32_t i) { return samplers ? samplers[i] : 0u; };
+		if (!cache->UpdateSlots(cached, TextureUnitCount, first, count, valueAt, &begin, &end))
+			return;
+		first += begin;
+		count = end - begin;
+		if (samplers)
+			samplers += begin;
+	}
+	GLUTIL_GL_CALL(glBindSamplers(first, count, samplers));
+}
+
+void BindSamplers(uint32_t first, std::initializer_list<uint32_t> samplers)
+{
+	BindSamplers(first, static_cast<int32_t>(samplers.size()), samplers.begin());
+}
+
 } // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <GLUtil/SamplerCache.h>
+#include <GLUtil/Hash.h>
+
+#include <cstring>
+
+namespace GLUtil {
+
+SamplerDesc::SamplerDesc()
+{
+	memset(static_cast<void*>(this), 0, sizeof(SamplerDesc));
+	minFilter = TextureFilter::NearestMipmapLinear;
+	magFilter = TextureFilter::Linear;
+	wrapS = wrapT = wrapR = TextureWrap::Repeat;
+	minLod = -1000.0f;
+	maxLod = 1000.0f;
+	lodBias = 0.0f;
+	compareMode = TextureCompareMode::None;
+	compareFunc = CompareFunc::LessEqual;
+	borderColor = Vec4f(0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+SamplerDesc& SamplerDesc::SetFilter(TextureFilter min, TextureFilter mag)
+{
+	minFilter = min;
+	magFilter = mag;
+	return *this;
+}
+
+SamplerDesc& SamplerDesc::SetWrap(TextureWrap wrap)
+{
+	wrapS = wrapT = wrapR = wrap;
+	return *this;
+}
+
+SamplerDesc& SamplerDesc::SetCompare(CompareFunc func)
+{
+	compareMode = TextureCompareMode::RefToTexture;
+	compareFunc = func;
+	return *this;
+}
+
+uint64_t SamplerDesc::Hash() const
+{
+	return HashBytes(this, sizeof(SamplerDesc));
+}
+
+bool SamplerDesc::operator==(const SamplerDesc& other) const
+{
+	return memcmp(this, &other, sizeof(SamplerDesc)) == 0;
+}
+
+bool SamplerDesc::operator!=(const SamplerDesc& other) const
+{
+	return !(*this == other);
+}
+
+SamplerCache::SamplerCache() :
+	mHits(0), mMisses(0)
+{}
+
+SamplerCache::~SamplerCache()
+{}
+
+std::shared_ptr<Sampler> SamplerCache::Get(const SamplerDesc& desc)
+{
+	auto it = mSamplers.find(desc);
+	if (it != mSamplers.end()) {
+		mHits++;
+		return it->second;
+	}
+
+	mMisses++;
+	auto sampler = std::make_shared<Sampler>(Sampler::Create());
+	sampler->SetMinFilter(desc.minFilter)
+		.SetMagFilter(desc.magFilter)
+		.SetWrapS(desc.wrapS)
+		.SetWrapT(desc.wrapT)
+		.SetWrapR(desc.wrapR)
+		.SetMinLod(desc.minLod)
+		.SetMaxLod(desc.maxLod)
+		.SetLodBias(desc.lodBias)
+		.SetCompareMode(desc.compareMode)
+		.SetCompareFunc(desc.compareFunc)
+		.SetBorderColorF(desc.borderColor);
+	mSamplers.emplace(desc, sampler);
+	return sampler;
+}
+
+uint32_t SamplerCache::Purge()
+{
+	uint32_t count = 0;
+	for (auto it = mSamplers.begin(); it != mSamplers.end();) {
+		if (it->second.use_count() == 1) {
+			it = mSamplers.erase(it);
+			count++;
+		} else {
+			++it;
+		}
+	}
+	return count;
+}
+
+void SamplerCache::Clear()
+{
+	mSamplers.clear();
+}
+
+uint32_t SamplerCache::GetCount() const
+{
+	return static_cast<uint32_t>(mSamplers.size());
+}
+
+uint64_t SamplerCache::GetHits() const
+{
+	return mHits;
+}
+
+uint64_t SamplerCache::GetMisses() const
+{
+	return mMisses;
+}
+
+} // namespace GLUtil
\ No newline at end of file
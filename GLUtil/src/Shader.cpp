@@ -44,6 +44,24 @@ Shader& Shader::Source(const char* src)
 	return Source(1, &src, &len);
 }
 
+// Length of the #version line including its newline, the defines go right after it
+static size_t GetVersionLineLength(const char* source)
+{
+	const char* version = strstr(source, "#version");
+	if (!version)
+		return 0;
+	const char* end = strchr(version, '\n');
+	return end ? end - source + 1 : strlen(source);
+}
+
+Shader& Shader::Source(const char* src, const char* defines)
+{
+	size_t versionLength = GetVersionLineLength(src);
+	const char* strings[3] = { src, defines ? defines : "", src + versionLength };
+	int32_t lengths[3] = { static_cast<int32_t>(versionLength), -1, -1 };
+	return Source(3, strings, lengths);
+}
+
 bool Shader::SourceFile(const char* filename)
 {
 	FILE* file = fopen(filename, "r");
@@ -82,6 +100,11 @@ bool Shader::Compile()
 	return IsCompiled();
 }
 
+void Shader::CompileAsync()
+{
+	GLUTIL_GL_CALL(glCompileShader(*this));
+}
+
 int32_t Shader::GetInfoLog(int32_t maxLength, char* infoLog) const
 {
 	int32_t logLen = 0;
@@ -147,6 +170,14 @@ bool Shader::IsCompiled() const
 	return GetPropI(ShaderProp::CompileStatus) == GL_TRUE;
 }
 
+// Without KHR_parallel_shader_compile the status query simply blocks
+bool Shader::IsCompletionReady() const
+{
+	if (!GLAD_GL_KHR_parallel_shader_compile && !GLAD_GL_ARB_parallel_shader_compile)
+		return true;
+	return GetPropI(ShaderProp::CompletionStatus) == GL_TRUE;
+}
+
 int32_t Shader::GetInfoLogLength() const
 {
 	return GetPropI(ShaderProp::InfoLogLength);
@@ -1,28 +1,416 @@
 #include <GLUtil/State.h>
+#include <GLUtil/StateCache.h>
 
 #include <glad/gl.h>
 
 #define ENUM(e) static_cast<GLenum>(e)
 
+#define STATE_CACHED(member, value) \
+	if (StateCache* _cache = StateCache::GetCurrent()) { \
+		if (!_cache->Update(_cache->GetShadow().member, value)) \
+			return; \
+	}
+
+#define STATE_CACHED_FACES(member, face, value) \
+	if (StateCache* _cache = StateCache::GetCurrent()) { \
+		if (!_cache->UpdateFaces(_cache->GetShadow().member, face, value)) \
+			return; \
+	}
+
+#define STATE_INVALIDATE(member) \
+	if (StateCache* _cache = StateCache::GetCurrent()) { \
+		_cache->GetShadow().member.Invalidate(); \
+	}
+
 namespace GLUtil {
 
+void SetHint(Hint hint, HintPreference preference)
+{
+	GLUTIL_GL_CALL(glHint(ENUM(hint), ENUM(preference)));
+}
+
+void SetFragmentShaderDerivativeHint(HintPreference preference)
+{
+	SetHint(Hint::FragmentShaderDerivative, preference);
+}
+
+void SetLineSmoothHint(HintPreference preference)
+{
+	SetHint(Hint::LineSmooth, preference);
+}
+
+void SetPolygonSmoothHint(HintPreference preference)
+{
+	SetHint(Hint::PolygonSmooth, preference);
+}
+
+void SetTextureCompressionHint(HintPreference preference)
+{
+	SetHint(Hint::TextureCompression, preference);
+}
+
+void SetViewport(Vec2i offset, Vec2i size)
+{
+	SetViewport({ offset, size });
+}
+
+void SetViewport(Box box)
+{
+	STATE_CACHED(viewport, box);
+	GLUTIL_GL_CALL(glViewport(box.offset.x, box.offset.y, box.size.x, box.size.y));
+}
+
+void SetViewport(uint32_t index, Vec2i offset, Vec2i size)
+{
+	SetViewport(index, { offset, size });
+}
+
+void SetViewport(uint32_t index, Box box)
+{
+	STATE_INVALIDATE(viewport);
+	GLUTIL_GL_CALL(glViewportIndexedf(index, static_cast<float>(box.offset.x), static_cast<float>(box.offset.y), static_cast<float>(box.size.x), static_cast<float>(box.size.y)));
+}
+
+void SetViewportArray(uint32_t first, int32_t count, const Box* boxes)
+{
+	for (int32_t i = 0; i < count; i++)
+		SetViewport(first + i, boxes[i]);
+}
+
+void SetDepthClearValueD(double depth)
+{
+	STATE_CACHED(depthClearValue, depth);
+	GLUTIL_GL_CALL(glClearDepth(depth));
+}
+
+void SetDepthClearValueF(float depth)
+{
+	STATE_CACHED(depthClearValue, depth);
+	GLUTIL_GL_CALL(glClearDepthf(depth));
+}
+
+void SetDepthFunc(CompareFunc func)
+{
+	STATE_CACHED(depthFunc, func);
+	GLUTIL_GL_CALL(glDepthFunc(ENUM(func)));
+}
+
+void SetDepthMask(bool flag)
+{
+	STATE_CACHED(depthMask, flag);
+	GLUTIL_GL_CALL(glDepthMask(flag));
+}
+
+void SetDepthRangeD(double near, double far)
+{
+	STATE_CACHED(depthRange, Vec2d(near, far));
+	GLUTIL_GL_CALL(glDepthRange(near, far));
+}
+
+void SetDepthRangeF(float near, float far)
+{
+	STATE_CACHED(depthRange, Vec2d(near, far));
+	GLUTIL_GL_CALL(glDepthRangef(near, far));
+}
+
+void SetDepthRangeArray(uint32_t first, int32_t count, const double* v)
+{
+	STATE_INVALIDATE(depthRange);
+	GLUTIL_GL_CALL(glDepthRangeArrayv(first, count, v));
+}
+
+void SetDepthRangeIndexed(uint32_t index, double near, double far)
+{
+	STATE_INVALIDATE(depthRange);
+	GLUTIL_GL_CALL(glDepthRangeIndexed(index, near, far));
+}
+
+void SetStencilClearValue(int32_t value)
+{
+	STATE_CACHED(stencilClearValue, value);
+	GLUTIL_GL_CALL(glClearStencil(value));
+}
+
+void SetStencilFunc(CompareFunc func, int32_t ref, uint32_t mask)
+{
+	SetStencilFunc(Face::FrontAndBack, func, ref, mask);
+}
+
+void SetStencilFunc(Face face, CompareFunc func, int32_t ref, uint32_t mask)
+{
+	StencilFuncState state = { func, ref, mask };
+	STATE_CACHED_FACES(stencilFunc, face, state);
+	GLUTIL_GL_CALL(glStencilFuncSeparate(ENUM(face), ENUM(func), ref, mask));
+}
+
+void SetStencilWriteMask(uint32_t mask)
+{
+	SetStencilWriteMask(Face::FrontAndBack, mask);
+}
+
+void SetStencilWriteMask(Face face, uint32_t mask)
+{
+	STATE_CACHED_FACES(stencilWriteMask, face, mask);
+	GLUTIL_GL_CALL(glStencilMaskSeparate(ENUM(face), mask));
+}
+
+void SetStencilOp(StencilOp stencilFail, StencilOp depthFailStencilFail, StencilOp depthPassStencilPass)
+{
+	SetStencilOp(Face::FrontAndBack, stencilFail, depthFailStencilFail, depthPassStencilPass);
+}
+
+void SetStencilOp(Face face, StencilOp stencilFail, StencilOp depthFailStencilFail, StencilOp depthPassStencilPass)
+{
+	StencilOpState state = { stencilFail, depthFailStencilFail, depthPassStencilPass };
+	STATE_CACHED_FACES(stencilOp, face, state);
+	GLUTIL_GL_CALL(glStencilOpSeparate(ENUM(face), ENUM(stencilFail), ENUM(depthFailStencilFail), ENUM(depthPassStencilPass)));
+}
+
+void SetScissorBox(Vec2i offset, Vec2i size)
+{
+	SetScissorBox({ offset, size });
+}
+
+void SetScissorBox(Box box)
+{
+	STATE_CACHED(scissorBox, box);
+	GLUTIL_GL_CALL(glScissor(box.offset.x, box.offset.y, box.size.x, box.size.y));
+}
+
+void SetScissorBox(uint32_t index, Vec2i offset, Vec2i size)
+{
+	SetScissorBox(index, { offset, size });
+}
+
+void SetScissorBox(uint32_t index, Box box)
+{
+	STATE_INVALIDATE(scissorBox);
+	GLUTIL_GL_CALL(glScissorIndexed(index, box.offset.x, box.offset.y, box.size.x, box.size.y));
+}
+
+void SetScissorBoxArray(uint32_t first, int32_t count, const Box* boxes)
+{
+	STATE_INVALIDATE(scissorBox);
+	GLUTIL_GL_CALL(glScissorArrayv(first, count, reinterpret_cast<const int32_t*>(boxes)));
+}
+
+void SetBlendColor(Vec4f color)
+{
+	STATE_CACHED(blendColor, color);
+	GLUTIL_GL_CALL(glBlendColor(color.x, color.y, color.z, color.w));
+}
+
+void SetBlendEquation(BlendEquation mode)
+{
+	SetBlendEquation(mode, mode);
+}
+
+void SetBlendEquation(uint32_t buf, BlendEquation mode)
+{
+	SetBlendEquation(buf, mode, mode);
+}
+
+void SetBlendEquation(BlendEquation modeRGB, BlendEquation modeAlpha)
+{
+	BlendEquationState state = { modeRGB, modeAlpha };
+	STATE_CACHED(blendEquation, state);
+	GLUTIL_GL_CALL(glBlendEquationSeparate(ENUM(modeRGB), ENUM(modeAlpha)));
+}
+
+void SetBlendEquation(uint32_t buf, BlendEquation modeRGB, BlendEquation modeAlpha)
+{
+	STATE_INVALIDATE(blendEquation);
+	GLUTIL_GL_CALL(glBlendEquationSeparatei(buf, ENUM(modeRGB), ENUM(modeAlpha)));
+}
+
+void SetBlendFunc(BlendFunc srcFactor, BlendFunc dstFactor)
+{
+	SetBlendFunc(srcFactor, dstFactor, srcFactor, dstFactor);
+}
+
+void SetBlendFunc(uint32_t buf, BlendFunc srcFactor, BlendFunc dstFactor)
+{
+	SetBlendFunc(buf, srcFactor, dstFactor, srcFactor, dstFactor);
+}
+
+void SetBlendFunc(BlendFunc srcRGB, BlendFunc dstRGB, BlendFunc srcAlpha, BlendFunc dstAlpha)
+{
+	BlendFuncState state = { srcRGB, dstRGB, srcAlpha, dstAlpha };
+	STATE_CACHED(blendFunc, state);
+	GLUTIL_GL_CALL(glBlendFuncSeparate(ENUM(srcRGB), ENUM(dstRGB), ENUM(srcAlpha), ENUM(dstAlpha)));
+}
+
+void SetBlendFunc(uint32_t buf, BlendFunc srcRGB, BlendFunc dstRGB, BlendFunc srcAlpha, BlendFunc dstAlpha)
+{
+	STATE_INVALIDATE(blendFunc);
+	GLUTIL_GL_CALL(glBlendFuncSeparatei(buf, ENUM(srcRGB), ENUM(dstRGB), ENUM(srcAlpha), ENUM(dstAlpha)));
+}
+
+void SetClearColor(Vec4f color)
+{
+	STATE_CACHED(clearColor, color);
+	GLUTIL_GL_CALL(glClearColor(color.x, color.y, color.z, color.w));
+}
+
+void SetClampColor(uint32_t target, bool clamp)
+{
+	GLUTIL_GL_CALL(glClampColor(target, clamp));
+}
+
+void SetClampColor(bool clamp)
+{
+	SetClampColor(GL_CLAMP_READ_COLOR, clamp);
+}
+
+void SetColorWriteMask(Vec4b mask)
+{
+	STATE_CACHED(colorWriteMask, mask);
+	GLUTIL_GL_CALL(glColorMask(mask.x, mask.y, mask.z, mask.w));
+}
+
+void SetColorWriteMask(uint32_t buf, bool r, bool g, bool b, bool a)
+{
+	STATE_INVALIDATE(colorWriteMask);
+	GLUTIL_GL_CALL(glColorMaski(buf, r, g, b, a));
+}
+
+void SetLogicOpMode(LogicOp mode)
+{
+	STATE_CACHED(logicOpMode, mode);
+	GLUTIL_GL_CALL(glLogicOp(ENUM(mode)));
+}
+
+void SetSampleCoverage(float value, bool invert)
+{
+	SampleCoverageState state = { value, invert };
+	STATE_CACHED(sampleCoverage, state);
+	GLUTIL_GL_CALL(glSampleCoverage(value, invert));
+}
+
+void SetFrontFaceMode(FrontFaceMode mode)
+{
+	STATE_CACHED(frontFace, mode);
+	GLUTIL_GL_CALL(glFrontFace(ENUM(mode)));
+}
+
+void SetCullFace(Face face)
+{
+	STATE_CACHED(cullFace, face);
+	GLUTIL_GL_CALL(glCullFace(ENUM(face)));
+}
+
+void SetClipControl(Origin origin, ClipControlDepthMode depth)
+{
+	ClipControlState state = { origin, depth };
+	STATE_CACHED(clipControl, state);
+	GLUTIL_GL_CALL(glClipControl(ENUM(origin), ENUM(depth)));
+}
+
+void SetLineWidth(float width)
+{
+	STATE_CACHED(lineWidth, width);
+	GLUTIL_GL_CALL(glLineWidth(width));
+}
+
+void SetPointSize(float size)
+{
+	STATE_CACHED(pointSize, size);
+	GLUTIL_GL_CALL(glPointSize(size));
+}
+
+void SetPointParamF(PointParam pname, float value)
+{
+	GLUTIL_GL_CALL(glPointParameterf(ENUM(pname), value));
+}
+
+void SetPointParamI(PointParam pname, int32_t value)
+{
+	GLUTIL_GL_CALL(glPointParameteri(ENUM(pname), value));
+}
+
+void SetPointParam(PointParam pname, const float* value)
+{
+	GLUTIL_GL_CALL(glPointParameterfv(ENUM(pname), value));
+}
+
+void SetPointParam(PointParam pname, const int32_t* value)
+{
+	GLUTIL_GL_CALL(glPointParameteriv(ENUM(pname), value));
+}
+
+void SetPointFadeThresholdSize(float size)
+{
+	SetPointParamF(PointParam::FadeThresholdSize, size);
+}
+
+void SetPointSpriteCoordOrigin(Origin origin)
+{
+	SetPointParamI(PointParam::SpriteCoordOrigin, ENUM(origin));
+}
+
+void SetPolygonMode(Face face, PolygonMode mode)
+{
+	if (face == Face::FrontAndBack) {
+		STATE_CACHED(polygonMode, mode);
+	} else {
+		STATE_INVALIDATE(polygonMode);
+	}
+	GLUTIL_GL_CALL(glPolygonMode(ENUM(face), ENUM(mode)));
+}
+
+void SetPolygonOffset(float factor, float units)
+{
+	PolygonOffsetState state = { factor, units };
+	STATE_CACHED(polygonOffset, state);
+	GLUTIL_GL_CALL(glPolygonOffset(factor, units));
+}
+
+void SetPixelStoreParamF(PixelStoreParam pname, float value)
+{
+	STATE_INVALIDATE(pixelStore[PixelStoreParamToIndex(pname)]);
+	GLUTIL_GL_CALL(glPixelStoref(ENUM(pname), value));
+}
+
+void SetPixelStoreParamI(PixelStoreParam pname, int32_t value)
+{
+	STATE_CACHED(pixelStore[PixelStoreParamToIndex(pname)], value);
+	GLUTIL_GL_CALL(glPixelStorei(ENUM(pname), value));
+}
+
+// Answered by the current cache when it knows the value
+int32_t GetPixelStoreParamI(PixelStoreParam pname)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		const CachedValue<int32_t>& cached = cache->GetShadow().pixelStore[PixelStoreParamToIndex(pname)];
+		if (cached.IsValid())
+			return cached.Get();
+	}
+	int32_t value = 0;
+	GLUTIL_GL_CALL(glGetIntegerv(ENUM(pname), &value));
+	return value;
+}
+
 void EnableCapability(Capability cap)
 {
+	STATE_CACHED(capabilities[CapabilityToIndex(cap)], true);
 	GLUTIL_GL_CALL(glEnable(ENUM(cap)));
 }
 
 void EnableCapability(Capability cap, uint32_t index)
 {
+	STATE_INVALIDATE(capabilities[CapabilityToIndex(cap)]);
 	GLUTIL_GL_CALL(glEnablei(ENUM(cap), index));
 }
 
 void DisableCapability(Capability cap)
 {
+	STATE_CACHED(capabilities[CapabilityToIndex(cap)], false);
 	GLUTIL_GL_CALL(glDisable(ENUM(cap)));
 }
 
 void DisableCapability(Capability cap, uint32_t index)
 {
+	STATE_INVALIDATE(capabilities[CapabilityToIndex(cap)]);
 	GLUTIL_GL_CALL(glDisablei(ENUM(cap), index));
 }
 
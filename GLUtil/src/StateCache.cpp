@@ -0,0 +1,408 @@
+#include <GLUtil/StateCache.h>
+
+#include <glad/gl.h>
+
+#include <algorithm>
+
+#define ENUM(e) static_cast<GLenum>(e)
+
+namespace GLUtil {
+
+static thread_local StateCache* sCurrentCache = nullptr;
+
+static const Capability sCapabilities[CapabilityCount] = {
+	Capability::Blend,
+	Capability::ClipDistance,
+	Capability::ColorLogicOp,
+	Capability::CullFace,
+	Capability::DebugOutput,
+	Capability::DebugOutputSynchronous,
+	Capability::DepthClamp,
+	Capability::DepthTest,
+	Capability::FramebufferSRGB,
+	Capability::LineSmooth,
+	Capability::Multisample,
+	Capability::PolygonOffsetFill,
+	Capability::PolygonOffsetLine,
+	Capability::PolygonOffsetPoint,
+	Capability::PolygonSmooth,
+	Capability::PrimitiveRestart,
+	Capability::PrimitiveRestartFixedIndex,
+	Capability::RasterizerDiscard,
+	Capability::SampleAlphaToCoverage,
+	Capability::SampleAlphaToOne,
+	Capability::SampleCoverage,
+	Capability::SampleShading,
+	Capability::SampleMask,
+	Capability::ScissorTest,
+	Capability::StencilTest,
+	Capability::TextureCubemapSeamless,
+	Capability::ProgramPointSize
+};
+
+static const PixelStoreParam sPixelStoreParams[PixelStoreParamCount] = {
+	PixelStoreParam::PackSwapBytes,
+	PixelStoreParam::PackLsbFirst,
+	PixelStoreParam::PackRowLength,
+	PixelStoreParam::PackImageHeight,
+	PixelStoreParam::PackSkipPixels,
+	PixelStoreParam::PackSkipRows,
+	PixelStoreParam::PackSkipImages,
+	PixelStoreParam::PackAlignment,
+	PixelStoreParam::UnpackSwapBytes,
+	PixelStoreParam::UnpackLsbFirst,
+	PixelStoreParam::UnpackRowLength,
+	PixelStoreParam::UnpackImageHeight,
+	PixelStoreParam::UnpackSkipPixels,
+	PixelStoreParam::UnpackSkipRows,
+	PixelStoreParam::UnpackSkipImages,
+	PixelStoreParam::UnpackAlignment
+};
+
+static const BufferTarget sBufferTargets[BufferTargetCount] = {
+	BufferTarget::Array,
+	BufferTarget::AtomicCounter,
+	BufferTarget::CopyRead,
+	BufferTarget::CopyWrite,
+	BufferTarget::DispatchIndirect,
+	BufferTarget::DrawIndirect,
+	BufferTarget::ElementArray,
+	BufferTarget::PixelPack,
+	BufferTarget::PixelUnpack,
+	BufferTarget::Query,
+	BufferTarget::ShaderStorage,
+	BufferTarget::Texture,
+	BufferTarget::TransformFeedback,
+	BufferTarget::Uniform
+};
+
+static const TextureTarget sTextureTargets[TextureTargetCount] = {
+	TextureTarget::Tex1D,
+	TextureTarget::Tex2D,
+	TextureTarget::Tex3D,
+	TextureTarget::Tex1DArray,
+	TextureTarget::Tex2DArray,
+	TextureTarget::TexRectangle,
+	TextureTarget::TexCubeMap,
+	TextureTarget::TexCubeMapArray,
+	TextureTarget::TexBuffer,
+	TextureTarget::Tex2DMultisample,
+	TextureTarget::Tex2DMultisampleArray
+};
+
+int32_t CapabilityToIndex(Capability cap)
+{
+	for (uint32_t i = 0; i < CapabilityCount; i++) {
+		if (sCapabilities[i] == cap)
+			return i;
+	}
+	return -1;
+}
+
+Capability IndexToCapability(uint32_t index)
+{
+	return sCapabilities[index];
+}
+
+int32_t PixelStoreParamToIndex(PixelStoreParam pname)
+{
+	for (uint32_t i = 0; i < PixelStoreParamCount; i++) {
+		if (sPixelStoreParams[i] == pname)
+			return i;
+	}
+	return -1;
+}
+
+int32_t BufferTargetToIndex(BufferTarget target)
+{
+	for (uint32_t i = 0; i < BufferTargetCount; i++) {
+		if (sBufferTargets[i] == target)
+			return i;
+	}
+	return -1;
+}
+
+int32_t TextureTargetToIndex(TextureTarget target)
+{
+	for (uint32_t i = 0; i < TextureTargetCount; i++) {
+		if (sTextureTargets[i] == target)
+			return i;
+	}
+	return -1;
+}
+
+int32_t IndexedBufferTargetToIndex(BufferTarget target)
+{
+	switch (target) {
+		case BufferTarget::AtomicCounter: return 0;
+		case BufferTarget::TransformFeedback: return 1;
+		case BufferTarget::Uniform: return 2;
+		case BufferTarget::ShaderStorage: return 3;
+		default: return -1;
+	}
+}
+
+template<typename T>
+static void InvalidateAll(CachedValue<T>* values, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+		values[i].Invalidate();
+}
+
+static void ResetAll(CachedValue<uint32_t>* values, uint32_t count, uint32_t object)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		if (values[i].IsValid() && values[i].Get() == object)
+			values[i].Set(0);
+	}
+}
+
+static int32_t QueryInteger(GLenum pname)
+{
+	int32_t value = 0;
+	GLUTIL_GL_CALL(glGetIntegerv(pname, &value));
+	return value;
+}
+
+static float QueryFloat(GLenum pname)
+{
+	float value = 0.0f;
+	GLUTIL_GL_CALL(glGetFloatv(pname, &value));
+	return value;
+}
+
+StateCache::StateCache() :
+	mHits(0), mMisses(0)
+{}
+
+StateCache::~StateCache()
+{
+	if (sCurrentCache == this)
+		sCurrentCache = nullptr;
+}
+
+StateCache* StateCache::GetCurrent()
+{
+	return sCurrentCache;
+}
+
+void StateCache::SetCurrent(StateCache* cache)
+{
+	sCurrentCache = cache;
+}
+
+void StateCache::MakeCurrent()
+{
+	SetCurrent(this);
+}
+
+void StateCache::Invalidate()
+{
+	InvalidateAll(mShadow.capabilities, CapabilityCount);
+	mShadow.viewport.Invalidate();
+	mShadow.scissorBox.Invalidate();
+	mShadow.depthClearValue.Invalidate();
+	mShadow.depthFunc.Invalidate();
+	mShadow.depthMask.Invalidate();
+	mShadow.depthRange.Invalidate();
+	mShadow.stencilClearValue.Invalidate();
+	InvalidateAll(mShadow.stencilFunc, 2);
+	InvalidateAll(mShadow.stencilWriteMask, 2);
+	InvalidateAll(mShadow.stencilOp, 2);
+	mShadow.blendColor.Invalidate();
+	mShadow.blendEquation.Invalidate();
+	mShadow.blendFunc.Invalidate();
+	mShadow.clearColor.Invalidate();
+	mShadow.colorWriteMask.Invalidate();
+	mShadow.logicOpMode.Invalidate();
+	mShadow.sampleCoverage.Invalidate();
+	mShadow.frontFace.Invalidate();
+	mShadow.cullFace.Invalidate();
+	mShadow.clipControl.Invalidate();
+	mShadow.lineWidth.Invalidate();
+	mShadow.pointSize.Invalidate();
+	mShadow.polygonMode.Invalidate();
+	mShadow.polygonOffset.Invalidate();
+	InvalidateAll(mShadow.pixelStore, PixelStoreParamCount);
+
+	InvalidateAll(mShadow.bindings.buffers, BufferTargetCount);
+	mShadow.bindings.activeTextureUnit.Invalidate();
+	for (uint32_t i = 0; i < TextureUnitCount; i++)
+		InvalidateAll(mShadow.bindings.textures[i], TextureTargetCount);
+	InvalidateAll(mShadow.bindings.textureUnits, TextureUnitCount);
+	InvalidateAll(mShadow.bindings.samplers, TextureUnitCount);
+	InvalidateAll(mShadow.bindings.images, ImageUnitCount);
+	for (uint32_t i = 0; i < IndexedBufferTargetCount; i++)
+		InvalidateAll(mShadow.bindings.indexedBuffers[i], IndexedBufferCount);
+}
+
+// The unit, sampler, image and indexed buffer bindings stay invalid, they are relearned on first use
+void StateCache::Resync()
+{
+	Invalidate();
+
+	for (uint32_t i = 0; i < CapabilityCount; i++) {
+		GLUTIL_GL_CALL(GLboolean enabled = glIsEnabled(ENUM(sCapabilities[i])));
+		mShadow.capabilities[i].Set(enabled == GL_TRUE);
+	}
+
+	int32_t box[4] = { 0, 0, 0, 0 };
+	GLUTIL_GL_CALL(glGetIntegerv(GL_VIEWPORT, box));
+	mShadow.viewport.Set({ Vec2i(box[0], box[1]), Vec2i(box[2], box[3]) });
+	GLUTIL_GL_CALL(glGetIntegerv(GL_SCISSOR_BOX, box));
+	mShadow.scissorBox.Set({ Vec2i(box[0], box[1]), Vec2i(box[2], box[3]) });
+
+	double depthClear = 0.0;
+	GLUTIL_GL_CALL(glGetDoublev(GL_DEPTH_CLEAR_VALUE, &depthClear));
+	mShadow.depthClearValue.Set(depthClear);
+	mShadow.depthFunc.Set(static_cast<CompareFunc>(QueryInteger(GL_DEPTH_FUNC)));
+	mShadow.depthMask.Set(QueryInteger(GL_DEPTH_WRITEMASK) == GL_TRUE);
+	Vec2d depthRange;
+	GLUTIL_GL_CALL(glGetDoublev(GL_DEPTH_RANGE, depthRange.v));
+	mShadow.depthRange.Set(depthRange);
+
+	mShadow.stencilClearValue.Set(QueryInteger(GL_STENCIL_CLEAR_VALUE));
+	mShadow.stencilFunc[0].Set({ static_cast<CompareFunc>(QueryInteger(GL_STENCIL_FUNC)), QueryInteger(GL_STENCIL_REF), static_cast<uint32_t>(QueryInteger(GL_STENCIL_VALUE_MASK)) });
+	mShadow.stencilFunc[1].Set({ static_cast<CompareFunc>(QueryInteger(GL_STENCIL_BACK_FUNC)), QueryInteger(GL_STENCIL_BACK_REF), static_cast<uint32_t>(QueryInteger(GL_STENCIL_BACK_VALUE_MASK)) });
+	mShadow.stencilWriteMask[0].Set(static_cast<uint32_t>(QueryInteger(GL_STENCIL_WRITEMASK)));
+	mShadow.stencilWriteMask[1].Set(static_cast<uint32_t>(QueryInteger(GL_STENCIL_BACK_WRITEMASK)));
+	mShadow.stencilOp[0].Set({ static_cast<StencilOp>(QueryInteger(GL_STENCIL_FAIL)), static_cast<StencilOp>(QueryInteger(GL_STENCIL_PASS_DEPTH_FAIL)), static_cast<StencilOp>(QueryInteger(GL_STENCIL_PASS_DEPTH_PASS)) });
+	mShadow.stencilOp[1].Set({ static_cast<StencilOp>(QueryInteger(GL_STENCIL_BACK_FAIL)), static_cast<StencilOp>(QueryInteger(GL_STENCIL_BACK_PASS_DEPTH_FAIL)), static_cast<StencilOp>(QueryInteger(GL_STENCIL_BACK_PASS_DEPTH_PASS)) });
+
+	Vec4f color;
+	GLUTIL_GL_CALL(glGetFloatv(GL_BLEND_COLOR, color.v));
+	mShadow.blendColor.Set(color);
+	mShadow.blendEquation.Set({ static_cast<BlendEquation>(QueryInteger(GL_BLEND_EQUATION_RGB)), static_cast<BlendEquation>(QueryInteger(GL_BLEND_EQUATION_ALPHA)) });
+	mShadow.blendFunc.Set({
+		static_cast<BlendFunc>(QueryInteger(GL_BLEND_SRC_RGB)),
+		static_cast<BlendFunc>(QueryInteger(GL_BLEND_DST_RGB)),
+		static_cast<BlendFunc>(QueryInteger(GL_BLEND_SRC_ALPHA)),
+		static_cast<BlendFunc>(QueryInteger(GL_BLEND_DST_ALPHA))
+	});
+
+	GLUTIL_GL_CALL(glGetFloatv(GL_COLOR_CLEAR_VALUE, color.v));
+	mShadow.clearColor.Set(color);
+	GLboolean mask[4] = { GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE };
+	GLUTIL_GL_CALL(glGetBooleanv(GL_COLOR_WRITEMASK, mask));
+	mShadow.colorWriteMask.Set(Vec4b(mask[0] == GL_TRUE, mask[1] == GL_TRUE, mask[2] == GL_TRUE, mask[3] == GL_TRUE));
+	mShadow.logicOpMode.Set(static_cast<LogicOp>(QueryInteger(GL_LOGIC_OP_MODE)));
+	mShadow.sampleCoverage.Set({ QueryFloat(GL_SAMPLE_COVERAGE_VALUE), static_cast<uint32_t>(QueryInteger(GL_SAMPLE_COVERAGE_INVERT) == GL_TRUE) });
+
+	mShadow.frontFace.Set(static_cast<FrontFaceMode>(QueryInteger(GL_FRONT_FACE)));
+	mShadow.cullFace.Set(static_cast<Face>(QueryInteger(GL_CULL_FACE_MODE)));
+	mShadow.clipControl.Set({ static_cast<Origin>(QueryInteger(GL_CLIP_ORIGIN)), static_cast<ClipControlDepthMode>(QueryInteger(GL_CLIP_DEPTH_MODE)) });
+	mShadow.lineWidth.Set(QueryFloat(GL_LINE_WIDTH));
+	mShadow.pointSize.Set(QueryFloat(GL_POINT_SIZE));
+	// GL_POLYGON_MODE can't be queried in a core profile, it stays unknown until set
+	mShadow.polygonOffset.Set({ QueryFloat(GL_POLYGON_OFFSET_FACTOR), QueryFloat(GL_POLYGON_OFFSET_UNITS) });
+
+	for (uint32_t i = 0; i < PixelStoreParamCount; i++)
+		mShadow.pixelStore[i].Set(QueryInteger(ENUM(sPixelStoreParams[i])));
+
+	for (uint32_t i = 0; i < BufferTargetCount; i++)
+		mShadow.bindings.buffers[i].Set(QueryInteger(ENUM(BufferTargetToBinding(sBufferTargets[i]))));
+
+	uint32_t activeUnit = QueryInteger(GL_ACTIVE_TEXTURE) - GL_TEXTURE0;
+	uint32_t unitCount = std::min(static_cast<uint32_t>(QueryInteger(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS)), TextureUnitCount);
+	for (uint32_t i = 0; i < unitCount; i++) {
+		GLUTIL_GL_CALL(glActiveTexture(GL_TEXTURE0 + i));
+		for (uint32_t j = 0; j < TextureTargetCount; j++)
+			mShadow.bindings.textures[i][j].Set(QueryInteger(ENUM(TextureTargetToBinding(sTextureTargets[j]))));
+	}
+	GLUTIL_GL_CALL(glActiveTexture(GL_TEXTURE0 + activeUnit));
+	mShadow.bindings.activeTextureUnit.Set(activeUnit);
+}
+
+CachedValue<uint32_t>* StateCache::GetBufferBinding(BufferTarget target)
+{
+	int32_t index = BufferTargetToIndex(target);
+	return index >= 0 ? &mShadow.bindings.buffers[index] : nullptr;
+}
+
+CachedValue<uint32_t>* StateCache::GetTextureBinding(uint32_t unit, TextureTarget target)
+{
+	int32_t index = TextureTargetToIndex(target);
+	return index >= 0 && unit < TextureUnitCount ? &mShadow.bindings.textures[unit][index] : nullptr;
+}
+
+CachedValue<uint32_t>* StateCache::GetTextureUnitBinding(uint32_t unit)
+{
+	return unit < TextureUnitCount ? &mShadow.bindings.textureUnits[unit] : nullptr;
+}
+
+CachedValue<uint32_t>* StateCache::GetSamplerBinding(uint32_t unit)
+{
+	return unit < TextureUnitCount ? &mShadow.bindings.samplers[unit] : nullptr;
+}
+
+CachedValue<ImageBindingState>* StateCache::GetImageBinding(uint32_t unit)
+{
+	return unit < ImageUnitCount ? &mShadow.bindings.images[unit] : nullptr;
+}
+
+CachedValue<BufferRangeState>* StateCache::GetIndexedBufferBinding(BufferTarget target, uint32_t index)
+{
+	int32_t targetIndex = IndexedBufferTargetToIndex(target);
+	return targetIndex >= 0 && index < IndexedBufferCount ? &mShadow.bindings.indexedBuffers[targetIndex][index] : nullptr;
+}
+
+void StateCache::InvalidateTextureUnit(uint32_t unit)
+{
+	if (unit < TextureUnitCount)
+		InvalidateAll(mShadow.bindings.textures[unit], TextureTargetCount);
+}
+
+void StateCache::ResetBuffer(uint32_t buffer)
+{
+	ResetAll(mShadow.bindings.buffers, BufferTargetCount, buffer);
+	for (uint32_t i = 0; i < IndexedBufferTargetCount; i++) {
+		for (CachedValue<BufferRangeState>& binding : mShadow.bindings.indexedBuffers[i]) {
+			if (binding.IsValid() && binding.Get().buffer == buffer)
+				binding.Set({ 0, 0, 0, 1 });
+		}
+	}
+}
+
+void StateCache::ResetTexture(uint32_t texture)
+{
+	for (uint32_t i = 0; i < TextureUnitCount; i++)
+		ResetAll(mShadow.bindings.textures[i], TextureTargetCount, texture);
+	ResetAll(mShadow.bindings.textureUnits, TextureUnitCount, texture);
+	for (CachedValue<ImageBindingState>& binding : mShadow.bindings.images) {
+		if (binding.IsValid() && binding.Get().texture == texture)
+			binding.Invalidate();
+	}
+}
+
+void StateCache::ResetSampler(uint32_t sampler)
+{
+	ResetAll(mShadow.bindings.samplers, TextureUnitCount, sampler);
+}
+
+StateShadow& StateCache::GetShadow()
+{
+	return mShadow;
+}
+
+const StateShadow& StateCache::GetShadow() const
+{
+	return mShadow;
+}
+
+uint64_t StateCache::GetHits() const
+{
+	return mHits;
+}
+
+uint64_t StateCache::GetMisses() const
+{
+	return mMisses;
+}
+
+void StateCache::ResetCounters()
+{
+	mHits = 0;
+	mMisses = 0;
+}
+
+} // namespace GLUtil
\ No newline at end of file
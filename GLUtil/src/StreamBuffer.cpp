@@ -0,0 +1,158 @@
+#include <GLUtil/StreamBuffer.h>
+
+#include <glad/gl.h>
+
+#include <cstring>
+
+namespace GLUtil {
+
+static intptr_t AlignUp(intptr_t value, intptr_t alignment)
+{
+	return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+StreamRingBuffer::StreamRingBuffer(intptr_t size, Flags<BufferStorageFlags> extraFlags) :
+	mMapped(nullptr), mSize(size), mHead(0), mTail(0), mUsed(0), mFrameUsed(0)
+{
+	mBuffer.Storage(size, nullptr, extraFlags | Flags<BufferStorageFlags>({ BufferStorageFlags::MapWrite, BufferStorageFlags::MapPersistent, BufferStorageFlags::MapCoherent }));
+	mMapped = static_cast<uint8_t*>(mBuffer.MapRange(0, size, { BufferAccessFlags::Write, BufferAccessFlags::Persistent, BufferAccessFlags::Coherent }));
+}
+
+bool StreamRingBuffer::Reserve(intptr_t size, intptr_t alignment, intptr_t* offset)
+{
+	if (mUsed == 0)
+		mHead = mTail = 0;
+
+	if (mUsed == 0 || mHead > mTail) {
+		intptr_t start = AlignUp(mHead, alignment);
+		if (start + size <= mSize) {
+			mUsed += start + size - mHead;
+			mFrameUsed += start + size - mHead;
+			mHead = start + size;
+			*offset = start;
+			return true;
+		}
+
+		// Wrap around, the unused tail of the buffer counts towards this frame
+		if (size <= mTail) {
+			intptr_t consumed = mSize - mHead + size;
+			mUsed += consumed;
+			mFrameUsed += consumed;
+			mHead = size;
+			*offset = 0;
+			return true;
+		}
+		return false;
+	}
+
+	if (mHead < mTail) {
+		intptr_t start = AlignUp(mHead, alignment);
+		if (start + size <= mTail) {
+			mUsed += start + size - mHead;
+			mFrameUsed += start + size - mHead;
+			mHead = start + size;
+			*offset = start;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Returns false when waiting failed, e.g. after losing the context
+bool StreamRingBuffer::Retire(bool wait)
+{
+	while (!mInFlight.empty()) {
+		Region& region = mInFlight.front();
+		if (wait) {
+			SyncWaitResult result = region.fence.ClientWait(UINT64_MAX);
+			if (result == SyncWaitResult::WaitFailed)
+				return false;
+			wait = false;
+		} else if (!region.fence.IsSignaled()) {
+			return true;
+		}
+
+		mTail = region.end;
+		mUsed -= region.used;
+		mInFlight.pop_front();
+	}
+	return true;
+}
+
+StreamAllocation StreamRingBuffer::Allocate(intptr_t size, intptr_t alignment)
+{
+	StreamAllocation allocation = { nullptr, 0, 0 };
+	if (!mMapped || size <= 0 || size > mSize)
+		return allocation;
+
+	Retire(false);
+
+	intptr_t offset = 0;
+	while (!Reserve(size, alignment, &offset)) {
+		if (mInFlight.empty() || !Retire(true))
+			return allocation;
+	}
+
+	allocation.ptr = mMapped + offset;
+	allocation.offset = offset;
+	allocation.size = size;
+	return allocation;
+}
+
+StreamAllocation StreamRingBuffer::Write(const void* data, intptr_t size, intptr_t alignment)
+{
+	StreamAllocation allocation = Allocate(size, alignment);
+	if (allocation.ptr)
+		memcpy(allocation.ptr, data, size);
+	return allocation;
+}
+
+void StreamRingBuffer::EndFrame()
+{
+	if (!mFrameUsed)
+		return;
+
+	Region region;
+	region.end = mHead;
+	region.used = mFrameUsed;
+	region.fence = Fence::Create();
+	mInFlight.push_back(std::move(region));
+	mFrameUsed = 0;
+}
+
+void StreamRingBuffer::Finish()
+{
+	EndFrame();
+	while (!mInFlight.empty()) {
+		if (!Retire(true))
+			return;
+	}
+}
+
+const Buffer& StreamRingBuffer::GetBuffer() const
+{
+	return mBuffer;
+}
+
+void* StreamRingBuffer::GetMapPointer() const
+{
+	return mMapped;
+}
+
+intptr_t StreamRingBuffer::GetSize() const
+{
+	return mSize;
+}
+
+intptr_t StreamRingBuffer::GetUsed() const
+{
+	return mUsed;
+}
+
+intptr_t StreamRingBuffer::GetFrameUsed() const
+{
+	return mFrameUsed;
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include <GLUtil/Sync.h>
+
+#include <glad/gl.h>
+
+#include <algorithm>
+
+#define SYNC static_cast<GLsync>(mSync)
+
+namespace GLUtil {
+
+Fence::Fence() :
+	mSync(nullptr)
+{}
+
+Fence::Fence(Fence&& other) noexcept
+{
+	mSync = other.mSync;
+	other.mSync = nullptr;
+}
+
+Fence& Fence::operator=(Fence&& other) noexcept
+{
+	void* temp = mSync;
+	mSync = other.mSync;
+	other.mSync = temp;
+	return *this;
+}
+
+Fence::~Fence()
+{
+	Delete();
+}
+
+Fence Fence::Create()
+{
+	Fence fence;
+	GLUTIL_GL_CALL(fence.mSync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	return fence;
+}
+
+void Fence::Delete()
+{
+	if (mSync) {
+		GLUTIL_GL_CALL(glDeleteSync(SYNC));
+		mSync = nullptr;
+	}
+}
+
+SyncWaitResult Fence::ClientWait(uint64_t timeout, bool flush) const
+{
+	if (!mSync)
+		return SyncWaitResult::AlreadySignaled;
+	GLUTIL_GL_CALL(GLenum result = glClientWaitSync(SYNC, flush ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout));
+	return static_cast<SyncWaitResult>(result);
+}
+
+bool Fence::Wait() const
+{
+	SyncWaitResult result = ClientWait(0, true);
+	while (result == SyncWaitResult::TimeoutExpired)
+		result = ClientWait(UINT64_MAX, false);
+	return result != SyncWaitResult::WaitFailed;
+}
+
+void Fence::ServerWait() const
+{
+	if (mSync) {
+		GLUTIL_GL_CALL(glWaitSync(SYNC, 0, GL_TIMEOUT_IGNORED));
+	}
+}
+
+bool Fence::IsSignaled() const
+{
+	if (!mSync)
+		return true;
+	int32_t status = GL_UNSIGNALED;
+	GLUTIL_GL_CALL(glGetSynciv(SYNC, GL_SYNC_STATUS, 1, nullptr, &status));
+	return status == GL_SIGNALED;
+}
+
+void* Fence::GetSync() const
+{
+	return mSync;
+}
+
+Fence::operator bool() const
+{
+	return mSync != nullptr;
+}
+
+FramePacer::FramePacer(uint32_t framesInFlight) :
+	mFences(std::max(framesInFlight, 1u)), mFrame(0), mCompleted(0), mStalls(0)
+{}
+
+// The fences signal in order, so every frame up to this one is done as well
+void FramePacer::Complete(uint64_t frame)
+{
+	for (uint64_t i = mCompleted; i <= frame; i++)
+		mFences[i % mFences.size()].Delete();
+	mCompleted = frame + 1;
+}
+
+void FramePacer::BeginFrame()
+{
+	if (mFrame < mFences.size())
+		return;
+	uint64_t frame = mFrame - mFences.size();
+	if (frame < mCompleted)
+		return;
+	const Fence& fence = mFences[frame % mFences.size()];
+	if (!fence.IsSignaled()) {
+		mStalls++;
+		fence.Wait();
+	}
+	Complete(frame);
+}
+
+void FramePacer::EndFrame()
+{
+	mFences[mFrame % mFences.size()] = Fence::Create();
+	mFrame++;
+}
+
+void FramePacer::Finish()
+{
+	if (mFrame > 0)
+		WaitForFrame(mFrame - 1);
+}
+
+bool FramePacer::IsFrameComplete(uint64_t frame)
+{
+	if (frame < mCompleted)
+		return true;
+	if (frame >= mFrame)
+		return false;
+	if (!mFences[frame % mFences.size()].IsSignaled())
+		return false;
+	Complete(frame);
+	return true;
+}
+
+bool FramePacer::WaitForFrame(uint64_t frame)
+{
+	if (frame < mCompleted)
+		return true;
+	if (frame >= mFrame)
+		return false;
+	if (!mFences[frame % mFences.size()].Wait())
+		return false;
+	Complete(frame);
+	return true;
+}
+
+uint64_t FramePacer::GetFrame() const
+{
+	return mFrame;
+}
+
+uint32_t FramePacer::GetFrameSlot() const
+{
+	return static_cast<uint32_t>(mFrame % mFences.size());
+}
+
+uint32_t FramePacer::GetFramesInFlight() const
+{
+	return static_cast<uint32_t>(mFences.size());
+}
+
+uint64_t FramePacer::GetCompletedFrames() const
+{
+	return mCompleted;
+}
+
+uint64_t FramePacer::GetStalls() const
+{
+	return mStalls;
+}
+
+} // namespace GLUtil
\ No newline at end of file
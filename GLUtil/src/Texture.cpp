@@ -1,10 +1,12 @@
 #include <GLUtil/Texture.h>
+#include <GLUtil/StateCache.h>
 
 #include <glad/gl.h>
 #include <stb/image.h>
 
 #include <cmath>
 #include <algorithm>
+#include <utility>
 
 #define TEXTURE_BIND TextureBind _bind(target, *this)
 #define ENUM(e) static_cast<GLenum>(e)
@@ -14,23 +16,23 @@ namespace GLUtil {
 TextureBind::TextureBind(TextureTarget target, uint32_t texture) :
 	mTarget(target), mPrev(GetBoundTexture(target))
 {
-	GLUTIL_GL_CALL(glBindTexture(ENUM(target), texture));
+	BindTexture(target, texture);
 }
 
 TextureBind::~TextureBind()
 {
-	GLUTIL_GL_CALL(glBindTexture(ENUM(mTarget), mPrev));
+	BindTexture(mTarget, mPrev);
 }
 
 ScopeActiveTexture::ScopeActiveTexture(uint32_t unit) :
 	mPrev(GetActiveTextureUnit())
 {
-	GLUTIL_GL_CALL(glActiveTexture(GL_TEXTURE0 + unit));
+	SetActiveTextureUnit(unit);
 }
 
 ScopeActiveTexture::~ScopeActiveTexture()
 {
-	GLUTIL_GL_CALL(glActiveTexture(GL_TEXTURE0 + mPrev));
+	SetActiveTextureUnit(mPrev);
 }
 
 TextureBinding TextureTargetToBinding(TextureTarget target)
@@ -93,10 +95,22 @@ TextureTarget TextureBindingToTarget(TextureBinding binding)
 	}
 }
 
+static CachedValue<uint32_t>* GetCachedBinding(TextureTarget target)
+{
+	StateCache* cache = StateCache::GetCurrent();
+	return cache ? cache->GetTextureBinding(GetActiveTextureUnit(), target) : nullptr;
+}
+
 uint32_t GetBoundTexture(TextureBinding binding)
 {
+	CachedValue<uint32_t>* cached = GetCachedBinding(TextureBindingToTarget(binding));
+	if (cached && cached->IsValid())
+		return cached->Get();
+
 	int32_t value = 0;
 	GLUTIL_GL_CALL(glGetIntegerv(ENUM(binding), &value));
+	if (cached)
+		cached->Set(value);
 	return value;
 }
 
@@ -107,21 +121,133 @@ uint32_t GetBoundTexture(TextureTarget target)
 
 uint32_t GetActiveTextureUnit()
 {
+	StateCache* cache = StateCache::GetCurrent();
+	if (cache && cache->GetShadow().bindings.activeTextureUnit.IsValid())
+		return cache->GetShadow().bindings.activeTextureUnit.Get();
+
 	int32_t value = 0;
 	GLUTIL_GL_CALL(glGetIntegerv(GL_ACTIVE_TEXTURE, &value));
+	if (cache)
+		cache->GetShadow().bindings.activeTextureUnit.Set(value - GL_TEXTURE0);
 	return value - GL_TEXTURE0;
 }
 
 void SetActiveTextureUnit(uint32_t unit)
 {
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		if (!cache->Update(cache->GetShadow().bindings.activeTextureUnit, unit))
+			return;
+	}
 	GLUTIL_GL_CALL(glActiveTexture(GL_TEXTURE0 + unit));
 }
 
-Texture::Texture(TextureTarget target)
+void BindTexture(TextureTarget target, uint32_t texture)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		uint32_t unit = GetActiveTextureUnit();
+		CachedValue<uint32_t>* cached = cache->GetTextureBinding(unit, target);
+		if (cached && !cache->Update(*cached, texture))
+			return;
+		if (CachedValue<uint32_t>* unitBinding = cache->GetTextureUnitBinding(unit))
+			unitBinding->Invalidate();
+	}
+	GLUTIL_GL_CALL(glBindTexture(ENUM(target), texture));
+}
+
+// The target of the texture isn't known here, so the per target bindings of the unit are forgotten
+void BindTextureUnit(uint32_t unit, uint32_t texture)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		CachedValue<uint32_t>* cached = cache->GetTextureUnitBinding(unit);
+		if (cached && !cache->Update(*cached, texture))
+			return;
+		cache->InvalidateTextureUnit(unit);
+	}
+	GLUTIL_GL_CALL(glBindTextureUnit(unit, texture));
+}
+
+void BindTextures(uint32_t first, int32_t count, const uint32_t* textures)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		uint32_t begin, end;
+		CachedValue<uint32_t>* cached = cache->GetTextureUnitBinding(0);
+		auto valueAt = [&](uint32_t i) { return textures ? textures[i] : 0u; };
+		if (!cache->UpdateSlots(cached, TextureUnitCount, first, count, valueAt, &begin, &end))
+			return;
+		first += begin;
+		count = end - begin;
+		if (textures)
+			textures += begin;
+		for (int32_t i = 0; i < count; i++)
+			cache->InvalidateTextureUnit(first + i);
+	}
+	GLUTIL_GL_CALL(glBindTextures(first, count, textures));
+}
+
+void BindTextures(uint32_t first, std::initializer_list<uint32_t> textures)
+{
+	BindTextures(first, static_cast<int32_t>(textures.size()), textures.begin());
+}
+
+void BindImageTexture(uint32_t unit, uint32_t texture, int32_t level, bool layered, int32_t layer, Access access, TextureInternalFormat format)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		CachedValue<ImageBindingState>* cached = cache->GetImageBinding(unit);
+		if (cached && !cache->Update(*cached, { texture, level, layered, layer, access, format }))
+			return;
+	}
+	GLUTIL_GL_CALL(glBindImageTexture(unit, texture, level, layered, layer, ENUM(access), ENUM(format)));
+}
+
+// The layering and format are chosen by the driver, the shadow marks them with
+// placeholders so multi binds only ever match other multi binds
+void BindImageTextures(uint32_t first, int32_t count, const uint32_t* textures)
+{
+	if (StateCache* cache = StateCache::GetCurrent()) {
+		uint32_t begin, end;
+		CachedValue<ImageBindingState>* cached = cache->GetImageBinding(0);
+		auto valueAt = [&](uint32_t i) {
+			return ImageBindingState{ textures ? textures[i] : 0u, 0, 0xFFFFFFFF, 0, Access::ReadWrite, static_cast<TextureInternalFormat>(0) };
+		};
+		if (!cache->UpdateSlots(cached, ImageUnitCount, first, count, valueAt, &begin, &end))
+			return;
+		first += begin;
+		count = end - begin;
+		if (textures)
+			textures += begin;
+	}
+	GLUTIL_GL_CALL(glBindImageTextures(first, count, textures));
+}
+
+void BindImageTextures(uint32_t first, std::initializer_list<uint32_t> textures)
+{
+	BindImageTextures(first, static_cast<int32_t>(textures.size()), textures.begin());
+}
+
+enum : uint32_t
+{
+	TargetKnown = 1,
+	StorageKnown = 2
+};
+
+Texture::Texture(TextureTarget target) :
+	mTarget(target), mFormat(), mSize(), mLevels(0), mKnown(TargetKnown)
 {
 	GLUTIL_GL_CALL(glCreateTextures(ENUM(target), 1, GetIDPtr()));
 }
 
+// The object IDs are swapped, the metadata has to follow them
+Texture& Texture::operator=(Texture&& other) noexcept
+{
+	GLObject::operator=(std::move(other));
+	std::swap(mTarget, other.mTarget);
+	std::swap(mFormat, other.mFormat);
+	std::swap(mSize, other.mSize);
+	std::swap(mLevels, other.mLevels);
+	std::swap(mKnown, other.mKnown);
+	return *this;
+}
+
 Texture::Texture(const char* filename, bool genMipmap) :
 	Texture(TextureTarget::Tex2D)
 {
@@ -129,12 +255,14 @@ Texture::Texture(const char* filename, bool genMipmap) :
 }
 
 Texture::Texture(uint32_t texture) :
-	GLObject(texture)
+	GLObject(texture), mTarget(), mFormat(), mSize(), mLevels(0), mKnown(0)
 {}
 
 Texture::~Texture()
 {
 	if (*this) {
+		if (StateCache* cache = StateCache::GetCurrent())
+			cache->ResetTexture(*this);
 		GLUTIL_GL_CALL(glDeleteTextures(1, GetIDPtr()));
 	}
 }
@@ -147,40 +275,54 @@ bool Texture::LoadFile(const char* filename, bool genMipmap)
 	if (!pixels)
 		return false;
 
-	TextureInternalFormat internalFormat;
 	TextureBaseFormat format;
+	if (!StorageImage2D({ width, height }, channels, genMipmap, &format)) {
+		stbi_image_free(pixels);
+		return false;
+	}
+
+	SubImage2D(0, { 0, 0 }, { width, height }, format, DataType::UnsignedByte, pixels);
+	stbi_image_free(pixels);
+	if (genMipmap)
+		GenerateMipmap();
+
+	return true;
+}
+
+bool Texture::StorageImage2D(Vec2i size, int32_t channels, bool genMipmap, TextureBaseFormat* format)
+{
+	TextureInternalFormat internalFormat;
 	switch (channels) {
 		case STBI_grey:
 			internalFormat = TextureInternalFormat::R8;
-			format = TextureBaseFormat::R;
+			*format = TextureBaseFormat::R;
 			SetSwizzleG(TextureSwizzle::Red);
 			SetSwizzleB(TextureSwizzle::Red);
 			SetSwizzleA(TextureSwizzle::One);
 			break;
 		case STBI_grey_alpha:
 			internalFormat = TextureInternalFormat::RG8;
-			format = TextureBaseFormat::RG;
+			*format = TextureBaseFormat::RG;
 			SetSwizzleG(TextureSwizzle::Red);
 			SetSwizzleB(TextureSwizzle::Red);
 			SetSwizzleA(TextureSwizzle::Green);
 			break;
 		case STBI_rgb:
 			internalFormat = TextureInternalFormat::RGB8;
-			format = TextureBaseFormat::RGB;
+			*format = TextureBaseFormat::RGB;
 			SetSwizzleA(TextureSwizzle::One);
 			break;
 		case STBI_rgb_alpha:
 			internalFormat = TextureInternalFormat::RGBA8;
-			format = TextureBaseFormat::RGBA;
+			*format = TextureBaseFormat::RGBA;
 			break;
 		default:
-			stbi_image_free(pixels);
 			return false;
 	}
 
 	int levels = 1;
 	if (genMipmap) {
-		levels = (int)std::max(log2(width), log2(height)) + 1;
+		levels = (int)std::max(log2(size.x), log2(size.y)) + 1;
 		SetMinFilter(TextureFilter::LinearMipmapLinear);
 		SetMagFilter(TextureFilter::Nearest);
 	} else {
@@ -188,43 +330,42 @@ bool Texture::LoadFile(const char* filename, bool genMipmap)
 		SetMagFilter(TextureFilter::Nearest);
 	}
 
-	Storage2D(levels, internalFormat, { width, height });
-	SubImage2D(0, { 0, 0 }, { width, height }, format, DataType::UnsignedByte, pixels);
-	stbi_image_free(pixels);
-	if (genMipmap)
-		GenerateMipmap();
-
+	Storage2D(levels, internalFormat, size);
 	return true;
 }
 
 Texture& Texture::Storage1D(int32_t levels, TextureInternalFormat format, int32_t width)
 {
 	GLUTIL_GL_CALL(glTextureStorage1D(*this, levels, ENUM(format), width));
+	SetStorage(levels, format, { width, 1, 1 });
 	return *this;
 }
 
 Texture& Texture::Storage2D(int32_t levels, TextureInternalFormat format, Vec2i size)
 {
 	GLUTIL_GL_CALL(glTextureStorage2D(*this, levels, ENUM(format), size.x, size.y));
+	SetStorage(levels, format, { size, 1 });
 	return *this;
 }
 
 Texture& Texture::Storage2DMultisample(int32_t samples, TextureInternalFormat format, Vec2i size, bool fixedSampleLocations)
 {
 	GLUTIL_GL_CALL(glTextureStorage2DMultisample(*this, samples, ENUM(format), size.x, size.y, fixedSampleLocations));
+	SetStorage(1, format, { size, 1 });
 	return *this;
 }
 
 Texture& Texture::Storage3D(int32_t levels, TextureInternalFormat format, Vec3i size)
 {
 	GLUTIL_GL_CALL(glTextureStorage3D(*this, levels, ENUM(format), size.x, size.y, size.z));
+	SetStorage(levels, format, size);
 	return *this;
 }
 
-
 Texture& Texture::Storage3DMultisample(int32_t samples, TextureInternalFormat format, Vec3i size, bool fixedSampleLocations)
 {
 	GLUTIL_GL_CALL(glTextureStorage3DMultisample(*this, samples, ENUM(format), size.x, size.y, size.z, fixedSampleLocations));
+	SetStorage(1, format, size);
 	return *this;
 }
 
@@ -336,6 +477,8 @@ Texture& Texture::BufferRange(TextureInternalFormat format, uint32_t buffer, int
 Texture& Texture::View(TextureTarget target, uint32_t texture, TextureInternalFormat format, uint32_t minLevel, uint32_t levels, uint32_t minLayer, uint32_t layers)
 {
 	GLUTIL_GL_CALL(glTextureView(*this, ENUM(target), texture, ENUM(format), minLevel, levels, minLayer, layers));
+	// The view's storage depends on the viewed texture, the getters ask the driver
+	mKnown = 0;
 	return *this;
 }
 
@@ -425,23 +568,23 @@ Texture& Texture::InvalidateSubImage3D(int32_t level, Vec3i offset, Vec3i size)
 
 void Texture::Bind(TextureTarget target) const
 {
-	GLUTIL_GL_CALL(glBindTexture(ENUM(target), *this));
+	BindTexture(target, *this);
 }
 
 void Texture::Bind(TextureTarget target, uint32_t unit) const
 {
 	ScopeActiveTexture activeTex(unit);
-	GLUTIL_GL_CALL(glBindTexture(ENUM(target), *this));
+	BindTexture(target, *this);
 }
 
 void Texture::Bind(uint32_t unit) const
 {
-	GLUTIL_GL_CALL(glBindTextureUnit(unit, *this));
+	BindTextureUnit(unit, *this);
 }
 
 void Texture::BindImage(uint32_t unit, int32_t level, bool layered, int32_t layer, Access access, TextureInternalFormat format) const
 {
-	GLUTIL_GL_CALL(glBindImageTexture(unit, *this, level, layered, layer, ENUM(access), ENUM(format)));
+	BindImageTexture(unit, *this, level, layered, layer, access, format);
 }
 
 void Texture::GetCompressedImage(int32_t level, int32_t bufSize, void* pixels) const
@@ -510,16 +653,25 @@ float Texture::GetLevelPropF(int32_t level, TextureLevelProp pname) const
 
 int32_t Texture::GetLevelWidth(int32_t level) const
 {
+	if (IsLevelKnown(level))
+		return std::max(mSize.x >> level, 1);
 	return GetLevelPropI(level, TextureLevelProp::Width);
 }
 
+// The layers of array textures don't shrink with the level
 int32_t Texture::GetLevelHeight(int32_t level) const
 {
+	if (IsLevelKnown(level))
+		return mTarget == TextureTarget::Tex1DArray ? mSize.y : std::max(mSize.y >> level, 1);
 	return GetLevelPropI(level, TextureLevelProp::Height);
 }
 
 int32_t Texture::GetLevelDepth(int32_t level) const
 {
+	if (IsLevelKnown(level)) {
+		bool layered = mTarget == TextureTarget::Tex2DArray || mTarget == TextureTarget::TexCubeMapArray || mTarget == TextureTarget::Tex2DMultisampleArray;
+		return layered ? mSize.z : std::max(mSize.z >> level, 1);
+	}
 	return GetLevelPropI(level, TextureLevelProp::Depth);
 }
 
@@ -535,6 +687,8 @@ Vec3i Texture::GetLevelSize3D(int32_t level) const
 
 TextureInternalFormat Texture::GetLevelInternalFormat(int32_t level) const
 {
+	if (IsLevelKnown(level))
+		return mFormat;
 	return static_cast<TextureInternalFormat>(GetLevelPropI(level, TextureLevelProp::InternalFormat));
 }
 
@@ -928,8 +1082,11 @@ int32_t Texture::GetViewNumLayers() const
 	return GetPropI(TextureProp::ViewNumLayers);
 }
 
+// Textures created by GLUtil without a Storage call have no immutable storage
 int32_t Texture::GetNumImmutableLevels() const
 {
+	if (mKnown & TargetKnown)
+		return mLevels;
 	return GetPropI(TextureProp::NumImmutableLevels);
 }
 
@@ -940,12 +1097,33 @@ ImageFormatCompatibilityType Texture::GetImageFormatCompatibilityType() const
 
 bool Texture::IsImmutableFormat() const
 {
+	if (mKnown & TargetKnown)
+		return (mKnown & StorageKnown) != 0;
 	return GetPropI(TextureProp::IsImmutableFormat) == GL_TRUE;
 }
 
 TextureTarget Texture::GetTarget() const
 {
+	if (mKnown & TargetKnown)
+		return mTarget;
 	return static_cast<TextureTarget>(GetPropI(TextureProp::Target));
 }
 
+// A second Storage call fails on immutable storage
+void Texture::SetStorage(int32_t levels, TextureInternalFormat format, Vec3i size)
+{
+	if (mKnown & StorageKnown)
+		return;
+	mFormat = format;
+	mSize = size;
+	mLevels = levels;
+	mKnown |= StorageKnown;
+}
+
+// Only the storage of textures with a known target is tracked
+bool Texture::IsLevelKnown(int32_t level) const
+{
+	return (mKnown & (TargetKnown | StorageKnown)) == (TargetKnown | StorageKnown) && level >= 0 && level < mLevels;
+}
+
 } // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include <GLUtil/TextureAtlas.h>
+#include <GLUtil/Hash.h>
+#include <GLUtil/State.h>
+
+#include <stb/image.h>
+
+#include <algorithm>
+#include <climits>
+
+namespace GLUtil {
+
+TextureAtlas::TextureAtlas(Vec2i layerSize, TextureInternalFormat format, int32_t initialLayers, int32_t maxLayers, int32_t levels, int32_t padding) :
+	mTexture(TextureTarget::Tex2DArray), mFormat(format), mLayerSize(layerSize), mLayerCount(std::max(initialLayers, 1)),
+	mMaxLayers(std::max(maxLayers, mLayerCount)), mLevels(std::max(levels, 1)), mPadding(padding), mUsedArea(0)
+{
+	mTexture.Storage3D(mLevels, mFormat, { layerSize.x, layerSize.y, mLayerCount });
+	mTexture.SetMinFilter(mLevels > 1 ? TextureFilter::LinearMipmapLinear : TextureFilter::Linear);
+	mTexture.SetMagFilter(TextureFilter::Linear);
+	mSkylines.resize(mLayerCount, { { 0, 0, layerSize.x } });
+}
+
+// Lowest y at which a rectangle starting at the node fits over the skyline
+bool TextureAtlas::FitSkyline(const std::vector<SkylineNode>& skyline, size_t index, Vec2i size, int32_t* y) const
+{
+	int32_t x = skyline[index].x;
+	if (x + size.x > mLayerSize.x)
+		return false;
+
+	int32_t top = 0;
+	int32_t remaining = size.x;
+	for (size_t i = index; remaining > 0; i++) {
+		top = std::max(top, skyline[i].y);
+		if (top + size.y > mLayerSize.y)
+			return false;
+		remaining -= skyline[i].width;
+	}
+	*y = top;
+	return true;
+}
+
+// Bottom-left heuristic, the position with the lowest top edge wins and ties go to the narrower node
+bool TextureAtlas::Pack(Vec2i size, int32_t* layer, Vec2i* offset)
+{
+	for (int32_t l = 0; l < mLayerCount; l++) {
+		const std::vector<SkylineNode>& skyline = mSkylines[l];
+		int32_t bestTop = INT_MAX;
+		int32_t bestWidth = INT_MAX;
+		int32_t bestIndex = -1;
+		for (size_t i = 0; i < skyline.size(); i++) {
+			int32_t y;
+			if (!FitSkyline(skyline, i, size, &y))
+				continue;
+			if (y + size.y < bestTop || (y + size.y == bestTop && skyline[i].width < bestWidth)) {
+				bestTop = y + size.y;
+				bestWidth = skyline[i].width;
+				bestIndex = static_cast<int32_t>(i);
+				*offset = Vec2i(skyline[i].x, y);
+			}
+		}
+		if (bestIndex >= 0) {
+			*layer = l;
+			PlaceSkyline(mSkylines[l], *offset, size);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TextureAtlas::PlaceSkyline(std::vector<SkylineNode>& skyline, Vec2i offset, Vec2i size)
+{
+	auto it = std::find_if(skyline.begin(), skyline.end(), [&](const SkylineNode& node) { return node.x == offset.x; });
+	it = skyline.insert(it, { offset.x, offset.y + size.y, size.x });
+
+	// Shrink or drop the nodes now covered by the new one
+	int32_t right = offset.x + size.x;
+	auto next = it + 1;
+	while (next != skyline.end() && next->x < right) {
+		int32_t shrink = right - next->x;
+		if (next->width <= shrink) {
+			next = skyline.erase(next);
+		} else {
+			next->x += shrink;
+			next->width -= shrink;
+			break;
+		}
+	}
+
+	// Merge neighbours at the same height
+	for (size_t i = 0; i + 1 < skyline.size();) {
+		if (skyline[i].y == skyline[i + 1].y) {
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		} else {
+			i++;
+		}
+	}
+}
+
+// Immutable storage can't be resized, existing layers are copied into a larger array
+bool TextureAtlas::Grow()
+{
+	if (mLayerCount >= mMaxLayers)
+		return false;
+
+	int32_t layerCount = std::min(mLayerCount * 2, mMaxLayers);
+	Texture texture(TextureTarget::Tex2DArray);
+	texture.Storage3D(mLevels, mFormat, { mLayerSize.x, mLayerSize.y, layerCount });
+	texture.SetMinFilter(mLevels > 1 ? TextureFilter::LinearMipmapLinear : TextureFilter::Linear);
+	texture.SetMagFilter(TextureFilter::Linear);
+	for (int32_t level = 0; level < mLevels; level++) {
+		Vec2i size(std::max(mLayerSize.x >> level, 1), std::max(mLayerSize.y >> level, 1));
+		texture.CopyImageSubData3D(mTexture, TextureTarget::Tex2DArray, level, { 0, 0, 0 }, TextureTarget::Tex2DArray, level, { 0, 0, 0 }, { size.x, size.y, mLayerCount });
+	}
+
+	mTexture = std::move(texture);
+	mSkylines.resize(layerCount, { { 0, 0, mLayerSize.x } });
+	mLayerCount = layerCount;
+	return true;
+}
+
+AtlasEntry TextureAtlas::Add(Vec2i size, TextureBaseFormat format, DataType type, const void* pixels)
+{
+	AtlasEntry entry;
+	entry.uvRect = Vec4f(0.0f, 0.0f, 0.0f, 0.0f);
+	entry.layer = -1;
+	entry.offset = Vec2i(0, 0);
+	entry.size = size;
+
+	Vec2i padded(size.x + 2 * mPadding, size.y + 2 * mPadding);
+	if (size.x <= 0 || size.y <= 0 || padded.x > mLayerSize.x || padded.y > mLayerSize.y)
+		return entry;
+
+	int32_t layer;
+	Vec2i offset;
+	while (!Pack(padded, &layer, &offset)) {
+		if (!Grow())
+			return entry;
+	}
+
+	entry.layer = layer;
+	entry.offset = Vec2i(offset.x + mPadding, offset.y + mPadding);
+	entry.uvRect = Vec4f(
+		static_cast<float>(entry.offset.x) / mLayerSize.x,
+		static_cast<float>(entry.offset.y) / mLayerSize.y,
+		static_cast<float>(entry.offset.x + size.x) / mLayerSize.x,
+		static_cast<float>(entry.offset.y + size.y) / mLayerSize.y);
+	mUsedArea += static_cast<int64_t>(padded.x) * padded.y;
+
+	int32_t alignment = GetPixelStoreParamI(PixelStoreParam::UnpackAlignment);
+	SetPixelStoreParamI(PixelStoreParam::UnpackAlignment, 1);
+	mTexture.SubImage3D(0, { entry.offset.x, entry.offset.y, layer }, { size.x, size.y, 1 }, format, type, pixels);
+	SetPixelStoreParamI(PixelStoreParam::UnpackAlignment, alignment);
+	return entry;
+}
+
+AtlasEntry TextureAtlas::AddFile(const char* filename)
+{
+	uint64_t hash = HashString(filename);
+	auto it = mNamed.find(hash);
+	if (it != mNamed.end())
+		return it->second;
+
+	AtlasEntry entry;
+	entry.uvRect = Vec4f(0.0f, 0.0f, 0.0f, 0.0f);
+	entry.layer = -1;
+	entry.offset = Vec2i(0, 0);
+	entry.size = Vec2i(0, 0);
+
+	int width, height, channels;
+	stbi_set_flip_vertically_on_load(true);
+	stbi_uc* pixels = stbi_load(filename, &width, &height, &channels, STBI_rgb_alpha);
+	if (!pixels)
+		return entry;
+
+	entry = Add({ width, height }, TextureBaseFormat::RGBA, DataType::UnsignedByte, pixels);
+	stbi_image_free(pixels);
+	if (entry.layer >= 0)
+		mNamed.emplace(hash, entry);
+	return entry;
+}
+
+const AtlasEntry* TextureAtlas::Find(uint64_t hash) const
+{
+	auto it = mNamed.find(hash);
+	return it != mNamed.end() ? &it->second : nullptr;
+}
+
+void TextureAtlas::GenerateMipmap()
+{
+	if (mLevels > 1)
+		mTexture.GenerateMipmap();
+}
+
+const Texture& TextureAtlas::GetTexture() const
+{
+	return mTexture;
+}
+
+Vec2i TextureAtlas::GetLayerSize() const
+{
+	return mLayerSize;
+}
+
+int32_t TextureAtlas::GetLayerCount() const
+{
+	return mLayerCount;
+}
+
+float TextureAtlas::GetOccupancy() const
+{
+	return static_cast<float>(mUsedArea) / (static_cast<float>(mLayerSize.x) * mLayerSize.y * mLayerCount);
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include <GLUtil/TextureLoader.h>
+#include <GLUtil/State.h>
+
+#include <glad/gl.h>
+#include <stb/image.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+
+namespace GLUtil {
+
+enum class TextureLoadStatus
+{
+	Decoding,
+	Decoded,
+	Done,
+	Failed
+};
+
+struct TextureLoadState
+{
+	Texture texture;
+	std::string filename;
+	bool genMipmap;
+	TextureLoadCallback callback;
+	std::atomic<TextureLoadStatus> status;
+
+	Vec2i size;
+	int32_t channels;
+	// Either the staging offset or the decoded pixels when the staging buffer was full
+	intptr_t offset;
+	stbi_uc* pixels;
+
+	TextureLoadState() :
+		texture(TextureTarget::Tex2D), genMipmap(false), status(TextureLoadStatus::Decoding),
+		size(0, 0), channels(0), offset(-1), pixels(nullptr)
+	{}
+
+	~TextureLoadState()
+	{
+		if (pixels)
+			stbi_image_free(pixels);
+	}
+};
+
+TextureHandle::TextureHandle()
+{}
+
+TextureHandle::TextureHandle(std::shared_ptr<TextureLoadState> state) :
+	mState(std::move(state))
+{}
+
+bool TextureHandle::IsReady() const
+{
+	if (!mState)
+		return true;
+	TextureLoadStatus status = mState->status.load(std::memory_order_acquire);
+	return status == TextureLoadStatus::Done || status == TextureLoadStatus::Failed;
+}
+
+bool TextureHandle::Succeeded() const
+{
+	return mState && mState->status.load(std::memory_order_acquire) == TextureLoadStatus::Done;
+}
+
+Texture& TextureHandle::Get() const
+{
+	return mState->texture;
+}
+
+Vec2i TextureHandle::GetSize() const
+{
+	return IsReady() ? mState->size : Vec2i(0, 0);
+}
+
+bool TextureHandle::IsValid() const
+{
+	return mState != nullptr;
+}
+
+TextureLoader::TextureLoader(ThreadPool& pool, intptr_t stagingSize) :
+	mPool(pool), mMapped(nullptr), mSize(stagingSize), mHead(0), mTail(0), mUsed(0), mPending(0)
+{
+	mStaging.Storage(stagingSize, nullptr, { BufferStorageFlags::MapWrite, BufferStorageFlags::MapPersistent, BufferStorageFlags::MapCoherent });
+	mMapped = static_cast<uint8_t*>(mStaging.MapRange(0, stagingSize, { BufferAccessFlags::Write, BufferAccessFlags::Persistent, BufferAccessFlags::Coherent }));
+}
+
+TextureLoader::~TextureLoader()
+{
+	Finish();
+}
+
+// Same ring scheme as StreamRingBuffer, but slots are released out of order as the
+// workers finish, the tail only moves past a contiguous run of released slots
+bool TextureLoader::Reserve(intptr_t size, intptr_t* offset)
+{
+	size = (size + 15) & ~intptr_t(15);
+	if (!mMapped || size > mSize)
+		return false;
+
+	if (mUsed == 0)
+		mHead = mTail = 0;
+
+	intptr_t start = -1;
+	intptr_t consumed = size;
+	if (mUsed == 0 || mHead > mTail) {
+		if (mHead + size <= mSize) {
+			start = mHead;
+		} else if (size <= mTail) {
+			start = 0;
+			consumed += mSize - mHead;
+		}
+	} else if (mHead < mTail && mHead + size <= mTail) {
+		start = mHead;
+	}
+	if (start < 0)
+		return false;
+
+	mSlots.push_back({ start, start + size, consumed, false });
+	mHead = start + size;
+	mUsed += consumed;
+	*offset = start;
+	return true;
+}
+
+void TextureLoader::Release(intptr_t offset)
+{
+	for (Slot& slot : mSlots) {
+		if (slot.offset == offset && !slot.released) {
+			slot.released = true;
+			break;
+		}
+	}
+	while (!mSlots.empty() && mSlots.front().released) {
+		mTail = mSlots.front().end;
+		mUsed -= mSlots.front().consumed;
+		mSlots.pop_front();
+	}
+}
+
+void TextureLoader::Retire()
+{
+	while (!mInFlight.empty() && mInFlight.front().fence.IsSignaled()) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (intptr_t offset : mInFlight.front().offsets)
+			Release(offset);
+		mInFlight.pop_front();
+	}
+}
+
+// Runs on a worker, no GL calls in here. The state is moved into the queue so the
+// texture is never deleted on the worker.
+void TextureLoader::Decode(std::shared_ptr<TextureLoadState> state)
+{
+	int width, height, channels;
+	stbi_set_flip_vertically_on_load_thread(true);
+	stbi_uc* pixels = stbi_load(state->filename.c_str(), &width, &height, &channels, 0);
+
+	// The reserved slot belongs to this worker until the state is published, so the
+	// copy runs without the lock
+	if (pixels) {
+		state->size = Vec2i(width, height);
+		state->channels = channels;
+		intptr_t size = static_cast<intptr_t>(width) * height * channels;
+		intptr_t offset;
+		bool reserved;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			reserved = Reserve(size, &offset);
+		}
+		if (reserved) {
+			memcpy(mMapped + offset, pixels, size);
+			state->offset = offset;
+			stbi_image_free(pixels);
+		} else {
+			state->pixels = pixels;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDecoded.push_back(std::move(state));
+}
+
+TextureHandle TextureLoader::Load(const char* filename, bool genMipmap, TextureLoadCallback callback)
+{
+	auto state = std::make_shared<TextureLoadState>();
+	state->filename = filename;
+	state->genMipmap = genMipmap;
+	state->callback = std::move(callback);
+
+	mPending++;
+	TextureHandle handle(state);
+	mPool.Enqueue([this, state]() mutable { Decode(std::move(state)); });
+	return handle;
+}
+
+uint32_t TextureLoader::Update()
+{
+	Retire();
+
+	std::vector<std::shared_ptr<TextureLoadState>> decoded;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		decoded.swap(mDecoded);
+	}
+	if (decoded.empty())
+		return mPending;
+
+	// Rows of 1 and 3 channel images aren't 4 byte aligned
+	int32_t alignment = GetPixelStoreParamI(PixelStoreParam::UnpackAlignment);
+	SetPixelStoreParamI(PixelStoreParam::UnpackAlignment, 1);
+
+	Batch batch;
+	for (const auto& state : decoded) {
+		TextureBaseFormat format;
+		bool success = (state->offset >= 0 || state->pixels) && state->texture.StorageImage2D(state->size, state->channels, state->genMipmap, &format);
+		if (success) {
+			if (state->offset >= 0) {
+				BindBuffer(BufferTarget::PixelUnpack, mStaging);
+				state->texture.SubImage2D(0, { 0, 0 }, state->size, format, DataType::UnsignedByte, reinterpret_cast<const void*>(state->offset));
+				batch.offsets.push_back(state->offset);
+			} else {
+				BindBuffer(BufferTarget::PixelUnpack, 0);
+				state->texture.SubImage2D(0, { 0, 0 }, state->size, format, DataType::UnsignedByte, state->pixels);
+			}
+			if (state->genMipmap)
+				state->texture.GenerateMipmap();
+		} else if (state->offset >= 0) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			Release(state->offset);
+		}
+
+		if (state->pixels) {
+			stbi_image_free(state->pixels);
+			state->pixels = nullptr;
+		}
+		state->status.store(success ? TextureLoadStatus::Done : TextureLoadStatus::Failed, std::memory_order_release);
+		mPending--;
+		if (state->callback)
+			state->callback(state->texture, success);
+	}
+
+	BindBuffer(BufferTarget::PixelUnpack, 0);
+	SetPixelStoreParamI(PixelStoreParam::UnpackAlignment, alignment);
+
+	if (!batch.offsets.empty()) {
+		batch.fence = Fence::Create();
+		mInFlight.push_back(std::move(batch));
+	}
+	return mPending;
+}
+
+void TextureLoader::Finish()
+{
+	while (Update() > 0)
+		std::this_thread::yield();
+	for (Batch& batch : mInFlight)
+		batch.fence.ClientWait(UINT64_MAX);
+	Retire();
+}
+
+uint32_t TextureLoader::GetPendingCount() const
+{
+	return mPending;
+}
+
+intptr_t TextureLoader::GetStagingUsed() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mUsed;
+}
+
+} // namespace GLUtil
\ No newline at end of file
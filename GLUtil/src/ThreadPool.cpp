@@ -0,0 +1,108 @@
+#include <GLUtil/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace GLUtil {
+
+ThreadPool::ThreadPool(uint32_t threadCount) :
+	mStop(false)
+{
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	for (uint32_t i = 0; i < threadCount; i++)
+		mThreads.emplace_back(&ThreadPool::WorkerMain, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mCondition.notify_all();
+	for (std::thread& thread : mThreads)
+		thread.join();
+}
+
+void ThreadPool::WorkerMain()
+{
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this] { return mStop || !mTasks.empty(); });
+			if (mTasks.empty())
+				return;
+			task = std::move(mTasks.front());
+			mTasks.pop_front();
+		}
+		task();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mTasks.push_back(std::move(task));
+	}
+	mCondition.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& func)
+{
+	if (count == 0)
+		return;
+
+	grain = std::max<size_t>(grain, 1);
+	size_t chunkCount = (count + grain - 1) / grain;
+	if (chunkCount == 1 || mThreads.empty()) {
+		func(0, count);
+		return;
+	}
+
+	// Helpers may start after the call returned, so they share the state instead of pointing at the stack
+	struct State
+	{
+		std::atomic<size_t> next;
+		std::atomic<size_t> done;
+		std::mutex mutex;
+		std::condition_variable finished;
+		std::function<void(size_t, size_t)> func;
+	};
+	std::shared_ptr<State> state = std::make_shared<State>();
+	state->next = 0;
+	state->done = 0;
+	state->func = func;
+
+	auto work = [state, count, grain, chunkCount]() {
+		for (;;) {
+			size_t chunk = state->next++;
+			if (chunk >= chunkCount)
+				return;
+			size_t begin = chunk * grain;
+			state->func(begin, std::min(begin + grain, count));
+			if (++state->done == chunkCount) {
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->finished.notify_all();
+			}
+		}
+	};
+
+	size_t helpers = std::min(chunkCount - 1, mThreads.size());
+	for (size_t i = 0; i < helpers; i++)
+		Enqueue(work);
+	work();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [&state, chunkCount] { return state->done == chunkCount; });
+}
+
+uint32_t ThreadPool::GetThreadCount() const
+{
+	return static_cast<uint32_t>(mThreads.size());
+}
+
+} // namespace GLUtil
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include <GLUtil/Trace.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace GLUtil {
+
+struct TraceEvent
+{
+	const char* name;
+	uint64_t start;
+	uint64_t duration;
+};
+
+// Only the owning thread appends, EndCapture() reads up to the published count
+struct TraceBuffer
+{
+	std::unique_ptr<TraceEvent[]> events;
+	uint32_t capacity;
+	std::atomic<uint32_t> count;
+	uint32_t threadIndex;
+	uint32_t capture;
+	bool owned;
+};
+
+struct GpuTraceEvent
+{
+	const char* name;
+	uint64_t start;
+	uint64_t duration;
+	uint32_t depth;
+};
+
+struct TraceState
+{
+	std::mutex mutex;
+	std::vector<std::unique_ptr<TraceBuffer>> buffers;
+	std::vector<GpuTraceEvent> gpuEvents;
+	std::unordered_set<std::string> gpuNames;
+	int64_t gpuOffset;
+	bool gpuSynced;
+	uint32_t eventsPerThread;
+};
+
+static std::atomic<bool> sCapturing(false);
+static std::atomic<uint32_t> sCapture(0);
+static std::atomic<uint64_t> sDropped(0);
+
+static TraceState& GetState()
+{
+	static TraceState state;
+	return state;
+}
+
+// Hands the buffer back when its thread exits, so short lived workers don't leak one each
+struct TraceBufferOwner
+{
+	TraceBuffer* buffer = nullptr;
+
+	~TraceBufferOwner()
+	{
+		if (buffer) {
+			std::lock_guard<std::mutex> lock(GetState().mutex);
+			buffer->owned = false;
+		}
+	}
+};
+
+// Threads keep their buffer across captures, it's cleared when a new capture starts.
+// Buffers of exited threads are reused once their events are no longer part of the capture.
+static TraceBuffer* GetThreadBuffer()
+{
+	static thread_local TraceBufferOwner tOwner;
+	TraceBuffer*& tBuffer = tOwner.buffer;
+	uint32_t capture = sCapture.load(std::memory_order_acquire);
+	if (tBuffer && tBuffer->capture == capture)
+		return tBuffer;
+
+	TraceState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (!tBuffer) {
+		for (const std::unique_ptr<TraceBuffer>& buffer : state.buffers) {
+			if (!buffer->owned && buffer->capture != capture) {
+				tBuffer = buffer.get();
+				break;
+			}
+		}
+	}
+	if (!tBuffer) {
+		state.buffers.emplace_back(new TraceBuffer());
+		tBuffer = state.buffers.back().get();
+		tBuffer->capacity = 0;
+		tBuffer->threadIndex = static_cast<uint32_t>(state.buffers.size());
+	}
+	tBuffer->owned = true;
+	if (tBuffer->capacity != state.eventsPerThread) {
+		tBuffer->events.reset(new TraceEvent[state.eventsPerThread]);
+		tBuffer->capacity = state.eventsPerThread;
+	}
+	tBuffer->count.store(0, std::memory_order_relaxed);
+	tBuffer->capture = capture;
+	return tBuffer;
+}
+
+static void WriteEscaped(FILE* file, const char* str)
+{
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			fputc('\\', file);
+		if (static_cast<unsigned char>(*str) >= 0x20)
+			fputc(*str, file);
+	}
+}
+
+void TraceRecorder::BeginCapture(uint32_t eventsPerThread)
+{
+	TraceState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.gpuEvents.clear();
+	state.gpuNames.clear();
+	state.gpuSynced = false;
+	state.eventsPerThread = eventsPerThread ? eventsPerThread : 1;
+	// Events of exited threads were part of the last capture at most
+	for (const std::unique_ptr<TraceBuffer>& buffer : state.buffers) {
+		if (!buffer->owned) {
+			buffer->events.reset();
+			buffer->capacity = 0;
+		}
+	}
+	sDropped.store(0, std::memory_order_relaxed);
+	sCapture.fetch_add(1, std::memory_order_release);
+	sCapturing.store(true, std::memory_order_release);
+}
+
+bool TraceRecorder::EndCapture(const char* filename)
+{
+	if (!sCapturing.exchange(false))
+		return false;
+
+	TraceState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	uint32_t capture = sCapture.load(std::memory_order_relaxed);
+	const char* separator = "";
+	fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+	for (const std::unique_ptr<TraceBuffer>& buffer : state.buffers) {
+		if (buffer->capture != capture)
+			continue;
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"Thread %u\"}}", separator, buffer->threadIndex, buffer->threadIndex);
+		separator = ",\n";
+		uint32_t count = buffer->count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++) {
+			const TraceEvent& event = buffer->events[i];
+			fputs(",\n{\"name\":\"", file);
+			WriteEscaped(file, event.name);
+			fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->threadIndex, event.start * 1e-3, event.duration * 1e-3);
+		}
+	}
+
+	if (!state.gpuEvents.empty()) {
+		fprintf(file, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"GPU\"}}", separator);
+		for (const GpuTraceEvent& event : state.gpuEvents) {
+			fputs(",\n{\"name\":\"", file);
+			WriteEscaped(file, event.name);
+			fprintf(file, "\",\"ph\":\"X\",\"pid\":2,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}", event.start * 1e-3, event.duration * 1e-3, event.depth);
+		}
+	}
+	fputs("\n]}\n", file);
+
+	state.gpuEvents.clear();
+	state.gpuNames.clear();
+	return fclose(file) == 0;
+}
+
+bool TraceRecorder::IsCapturing()
+{
+	return sCapturing.load(std::memory_order_relaxed);
+}
+
+uint64_t TraceRecorder::Now()
+{
+	static const std::chrono::steady_clock::time_point sStart = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sStart).count();
+}
+
+void TraceRecorder::RecordCpu(const char* name, uint64_t start, uint64_t end)
+{
+	if (!sCapturing.load(std::memory_order_relaxed))
+		return;
+
+	TraceBuffer* buffer = GetThreadBuffer();
+	uint32_t index = buffer->count.load(std::memory_order_relaxed);
+	if (index >= buffer->capacity) {
+		sDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer->events[index] = { name, start, end > start ? end - start : 0 };
+	buffer->count.store(index + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::IsGpuClockSynced()
+{
+	TraceState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	return state.gpuSynced;
+}
+
+void TraceRecorder::SyncGpuClock(uint64_t gpuTimestamp)
+{
+	TraceState& state = GetState();
+	uint64_t now = Now();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.gpuOffset = static_cast<int64_t>(now - gpuTimestamp);
+	state.gpuSynced = true;
+}
+
+// GPU results arrive a few frames late and only a handful per frame, so these take the lock
+void TraceRecorder::RecordGpu(const char* name, uint64_t gpuStart, uint64_t gpuEnd, uint32_t depth)
+{
+	if (!sCapturing.load(std::memory_order_relaxed))
+		return;
+
+	TraceState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	if (!state.gpuSynced)
+		return;
+	const char* storedName = state.gpuNames.insert(name).first->c_str();
+	state.gpuEvents.push_back({ storedName, gpuStart + state.gpuOffset, gpuEnd > gpuStart ? gpuEnd - gpuStart : 0, depth });
+}
+
+uint64_t TraceRecorder::GetDroppedEvents()
+{
+	return sDropped.load(std::memory_order_relaxed);
+}
+
+TraceScope::TraceScope(const char* name) :
+	mName(name), mStart(TraceRecorder::Now())
+{}
+
+TraceScope::~TraceScope()
+{
+	TraceRecorder::RecordCpu(mName, mStart, TraceRecorder::Now());
+}
+
+} // namespace GLUtil
\ No newline at end of file
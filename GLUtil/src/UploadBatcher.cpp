@@ -0,0 +1,125 @@
+#include <GLUtil/UploadBatcher.h>
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace GLUtil {
+
+UploadBatcher::UploadBatcher(intptr_t stagingSize) :
+	mStaging(stagingSize), mLastWriteCount(0), mLastCopyCount(0)
+{}
+
+void UploadBatcher::Write(uint32_t buffer, intptr_t offset, intptr_t size, const void* data)
+{
+	if (size <= 0)
+		return;
+	if (void* ptr = Allocate(buffer, offset, size)) {
+		memcpy(ptr, data, size);
+		return;
+	}
+	Flush();
+	GLUTIL_GL_CALL(glNamedBufferSubData(buffer, offset, size, data));
+}
+
+// The staging ring can only reuse memory of flushed writes, so a full ring is flushed once
+void* UploadBatcher::Allocate(uint32_t buffer, intptr_t offset, intptr_t size)
+{
+	if (size <= 0 || size > mStaging.GetSize())
+		return nullptr;
+
+	StreamAllocation allocation = mStaging.Allocate(size, 1);
+	if (!allocation.ptr && !mCopies.empty()) {
+		Flush();
+		allocation = mStaging.Allocate(size, 1);
+	}
+	if (!allocation.ptr)
+		return nullptr;
+
+	mCopies.push_back({ buffer, static_cast<uint32_t>(mCopies.size()), allocation.offset, offset, size });
+	return allocation.ptr;
+}
+
+// Copies of one buffer sorted by destination offset
+void UploadBatcher::Merge(Copy* begin, Copy* end)
+{
+	bool overlap = false;
+	for (Copy* copy = begin + 1; copy < end; copy++) {
+		if (copy[-1].dstOffset + copy[-1].size > copy->dstOffset) {
+			overlap = true;
+			break;
+		}
+	}
+	if (overlap)
+		std::sort(begin, end, [](const Copy& a, const Copy& b) { return a.order < b.order; });
+
+	for (Copy* copy = begin; copy < end; copy++) {
+		if (!mMerged.empty()) {
+			Copy& last = mMerged.back();
+			if (last.buffer == copy->buffer && last.srcOffset + last.size == copy->srcOffset && last.dstOffset + last.size == copy->dstOffset) {
+				last.size += copy->size;
+				continue;
+			}
+		}
+		mMerged.push_back(*copy);
+	}
+}
+
+uint32_t UploadBatcher::Flush()
+{
+	mLastWriteCount = static_cast<uint32_t>(mCopies.size());
+	mLastCopyCount = 0;
+	if (mCopies.empty())
+		return 0;
+
+	std::sort(mCopies.begin(), mCopies.end(), [](const Copy& a, const Copy& b) {
+		if (a.buffer != b.buffer)
+			return a.buffer < b.buffer;
+		if (a.dstOffset != b.dstOffset)
+			return a.dstOffset < b.dstOffset;
+		return a.order < b.order;
+	});
+
+	mMerged.clear();
+	Copy* begin = mCopies.data();
+	Copy* end = begin + mCopies.size();
+	while (begin < end) {
+		Copy* next = begin + 1;
+		while (next < end && next->buffer == begin->buffer)
+			next++;
+		Merge(begin, next);
+		begin = next;
+	}
+
+	uint32_t staging = mStaging.GetBuffer();
+	for (const Copy& copy : mMerged)
+		CopyBufferSubData(staging, copy.buffer, copy.srcOffset, copy.dstOffset, copy.size);
+	mStaging.EndFrame();
+
+	mCopies.clear();
+	mLastCopyCount = static_cast<uint32_t>(mMerged.size());
+	return mLastCopyCount;
+}
+
+uint32_t UploadBatcher::GetPendingCount() const
+{
+	return static_cast<uint32_t>(mCopies.size());
+}
+
+uint32_t UploadBatcher::GetLastWriteCount() const
+{
+	return mLastWriteCount;
+}
+
+uint32_t UploadBatcher::GetLastCopyCount() const
+{
+	return mLastCopyCount;
+}
+
+const StreamRingBuffer& UploadBatcher::GetStaging() const
+{
+	return mStaging;
+}
+
+} // namespace GLUtil
\ No newline at end of file